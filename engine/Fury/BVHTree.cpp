@@ -0,0 +1,545 @@
+#include <algorithm>
+#include <limits>
+
+#include "Fury/BVHTree.h"
+#include "Fury/Collidable.h"
+#include "Fury/SceneNode.h"
+#include "Fury/Log.h"
+
+namespace fury
+{
+	const unsigned int BVHTree::INVALID_INDEX = 0xffffffff;
+
+	// number of bins used when searching the best split.
+	static const int SAH_BIN_COUNT = 12;
+
+	static float GetHalfArea(const float min[3], const float max[3])
+	{
+		float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+		return dx * dy + dy * dz + dz * dx;
+	}
+
+	BVHTree::Ptr BVHTree::Create(unsigned int leafSize, float rebuildRatio)
+	{
+		return std::make_shared<BVHTree>(leafSize, rebuildRatio);
+	}
+
+	BVHTree::BVHTree(unsigned int leafSize, float rebuildRatio) :
+		m_TypeIndex(typeid(BVHTree)), m_LeafSize(std::max(leafSize, 1u)), m_RebuildRatio(rebuildRatio)
+	{
+
+	}
+
+	BVHTree::~BVHTree()
+	{
+		Clear();
+		FURYD << "BVHTree::~BVHTree";
+	}
+
+	std::type_index BVHTree::GetTypeIndex() const
+	{
+		return m_TypeIndex;
+	}
+
+	void BVHTree::AddSceneNode(const std::shared_ptr<SceneNode> &sceneNode)
+	{
+		if (m_EntryMap.find(sceneNode.get()) != m_EntryMap.end())
+		{
+			UpdateSceneNode(sceneNode);
+			return;
+		}
+
+		Entry entry;
+		entry.sceneNode = sceneNode;
+		entry.primitive = INVALID_INDEX;
+
+		m_EntryMap.emplace(sceneNode.get(), m_Entries.size());
+		m_Entries.push_back(entry);
+
+		SetSceneManager(*sceneNode, shared_from_this());
+		RecordChange(sceneNode.get(), false);
+		m_RebuildDirty = true;
+	}
+
+	void BVHTree::RemoveSceneNode(const std::shared_ptr<SceneNode> &sceneNode)
+	{
+		auto it = m_EntryMap.find(sceneNode.get());
+		if (it == m_EntryMap.end())
+			return;
+
+		unsigned int entryIndex = it->second;
+		m_EntryMap.erase(it);
+
+		SetSceneManager(*sceneNode, nullptr);
+		RecordChange(sceneNode.get(), true);
+
+		unsigned int lastIndex = m_Entries.size() - 1;
+		if (entryIndex != lastIndex)
+		{
+			m_Entries[entryIndex] = std::move(m_Entries[lastIndex]);
+			m_EntryMap[m_Entries[entryIndex].sceneNode.get()] = entryIndex;
+		}
+		m_Entries.pop_back();
+
+		m_RebuildDirty = true;
+	}
+
+	void BVHTree::UpdateSceneNode(const std::shared_ptr<SceneNode> &sceneNode)
+	{
+		auto it = m_EntryMap.find(sceneNode.get());
+		if (it == m_EntryMap.end())
+		{
+			AddSceneNode(sceneNode);
+			return;
+		}
+
+		RecordChange(sceneNode.get(), false);
+
+		if (m_RebuildDirty)
+			return;
+
+		const BoxBounds &aabb = sceneNode->GetWorldAABB();
+		unsigned int primitive = m_Entries[it->second].primitive;
+
+		// switching between bounded and unbounded changes the tree's layout.
+		if ((primitive == INVALID_INDEX) != aabb.GetInfinite())
+		{
+			m_RebuildDirty = true;
+			return;
+		}
+
+		if (primitive != INVALID_INDEX)
+		{
+			m_PrimitiveBounds.Set(primitive, aabb);
+			m_RefitDirty = true;
+		}
+	}
+
+	void BVHTree::WalkScene(const Collidable &collider, const FilterFunc &filterFunc) const
+	{
+		// tree layout or bounds are stale until the next Flush.
+		if (m_RebuildDirty || m_RefitDirty)
+		{
+			for (auto &entry : m_Entries)
+			{
+				if (collider.IsInsideFast(entry.sceneNode->GetWorldAABB()))
+					filterFunc(entry.sceneNode);
+			}
+			return;
+		}
+
+		for (auto entryIndex : m_Unbounded)
+		{
+			auto &sceneNode = m_Entries[entryIndex].sceneNode;
+			if (collider.IsInsideFast(sceneNode->GetWorldAABB()))
+				filterFunc(sceneNode);
+		}
+
+		if (m_TreeNodes.empty())
+			return;
+
+		using TreeNodePair = std::pair<bool, unsigned int>;
+
+		std::vector<TreeNodePair> possiblePairs;
+		possiblePairs.push_back(std::make_pair(false, 0));
+
+		std::vector<unsigned char> results;
+
+		while (!possiblePairs.empty())
+		{
+			TreeNodePair currentPair = possiblePairs.back();
+			possiblePairs.pop_back();
+
+			bool tested = currentPair.first;
+			const TreeNode &treeNode = m_TreeNodes[currentPair.second];
+
+			if (!tested)
+			{
+				Side result = collider.IsInside(m_TreeNodeBounds[currentPair.second]);
+				if (result == Side::OUT)
+					continue;
+				else if (result == Side::IN)
+					tested = true;
+			}
+
+			if (treeNode.left != INVALID_INDEX)
+			{
+				// push right first, so left subtree is visited first.
+				possiblePairs.push_back(std::make_pair(tested, treeNode.right));
+				possiblePairs.push_back(std::make_pair(tested, treeNode.left));
+			}
+			else if (tested)
+			{
+				for (unsigned int i = 0; i < treeNode.count; i++)
+					filterFunc(m_Entries[m_Primitives[treeNode.start + i]].sceneNode);
+			}
+			else
+			{
+				results.resize(treeNode.count);
+				collider.IsInsideFastBatch(m_PrimitiveBounds, treeNode.start, treeNode.count, results.data());
+
+				for (unsigned int i = 0; i < treeNode.count; i++)
+				{
+					if (results[i])
+						filterFunc(m_Entries[m_Primitives[treeNode.start + i]].sceneNode);
+				}
+			}
+		}
+	}
+
+	void BVHTree::Clear()
+	{
+		for (auto &entry : m_Entries)
+			SetSceneManager(*entry.sceneNode, nullptr);
+
+		m_Entries.clear();
+		m_EntryMap.clear();
+		m_TreeNodes.clear();
+		m_TreeNodeBounds.clear();
+		m_Primitives.clear();
+		m_PrimitiveBounds.Clear();
+		m_Unbounded.clear();
+
+		m_BuildCost = 0.0f;
+		m_RebuildDirty = m_RefitDirty = false;
+
+		RecordReset();
+	}
+
+	void BVHTree::Rebuild()
+	{
+		m_RebuildDirty = true;
+	}
+
+	unsigned int BVHTree::GetTreeNodeCount() const
+	{
+		return m_TreeNodes.size();
+	}
+
+	unsigned int BVHTree::GetSceneNodeCount() const
+	{
+		return m_Entries.size();
+	}
+
+	float BVHTree::GetCost() const
+	{
+		return m_BuildCost;
+	}
+
+	void BVHTree::Flush()
+	{
+		if (m_RebuildDirty)
+		{
+			Build();
+		}
+		else if (m_RefitDirty)
+		{
+			float cost = Refit();
+			if (cost > m_BuildCost * m_RebuildRatio)
+				Build();
+		}
+	}
+
+	void BVHTree::Build()
+	{
+		std::vector<BuildPrimitive> primitives;
+		primitives.reserve(m_Entries.size());
+
+		m_Unbounded.clear();
+
+		for (unsigned int i = 0; i < m_Entries.size(); i++)
+		{
+			Entry &entry = m_Entries[i];
+			const BoxBounds &aabb = entry.sceneNode->GetWorldAABB();
+
+			entry.primitive = INVALID_INDEX;
+
+			if (aabb.GetInfinite())
+			{
+				m_Unbounded.push_back(i);
+				continue;
+			}
+
+			Vector4 min = aabb.GetMin(), max = aabb.GetMax();
+
+			BuildPrimitive primitive;
+			primitive.min[0] = min.x;
+			primitive.min[1] = min.y;
+			primitive.min[2] = min.z;
+			primitive.max[0] = max.x;
+			primitive.max[1] = max.y;
+			primitive.max[2] = max.z;
+			for (int j = 0; j < 3; j++)
+				primitive.center[j] = (primitive.min[j] + primitive.max[j]) * 0.5f;
+			primitive.entry = i;
+
+			primitives.push_back(primitive);
+		}
+
+		m_TreeNodes.clear();
+		m_TreeNodes.reserve(primitives.size() * 2 / m_LeafSize + 1);
+
+		if (!primitives.empty())
+			BuildNodes(primitives);
+
+		m_Primitives.resize(primitives.size());
+		m_PrimitiveBounds.Resize(primitives.size());
+
+		for (unsigned int i = 0; i < primitives.size(); i++)
+		{
+			Entry &entry = m_Entries[primitives[i].entry];
+			entry.primitive = i;
+
+			m_Primitives[i] = primitives[i].entry;
+			m_PrimitiveBounds.Set(i, entry.sceneNode->GetWorldAABB());
+		}
+
+		m_TreeNodeBounds.resize(m_TreeNodes.size());
+
+		m_RebuildDirty = false;
+		m_BuildCost = Refit();
+	}
+
+	void BVHTree::BuildNodes(std::vector<BuildPrimitive> &primitives)
+	{
+		struct BuildTask
+		{
+			unsigned int start, end, parent;
+
+			bool left;
+		};
+
+		// skewed sah splits can make the tree as deep as the primitive count,
+		// so use a stack instead of recursion.
+		std::vector<BuildTask> tasks;
+		tasks.push_back({ 0, (unsigned int)primitives.size(), INVALID_INDEX, false });
+
+		while (!tasks.empty())
+		{
+			BuildTask task = tasks.back();
+			tasks.pop_back();
+
+			unsigned int start = task.start, end = task.end;
+			unsigned int index = m_TreeNodes.size();
+
+			TreeNode treeNode;
+			treeNode.left = treeNode.right = INVALID_INDEX;
+			treeNode.parent = task.parent;
+			treeNode.start = start;
+			treeNode.count = end - start;
+			m_TreeNodes.push_back(treeNode);
+
+			if (task.parent != INVALID_INDEX)
+			{
+				TreeNode &parent = m_TreeNodes[task.parent];
+				if (task.left)
+					parent.left = index;
+				else
+					parent.right = index;
+				parent.start = parent.count = 0;
+			}
+
+			if (treeNode.count <= m_LeafSize)
+				continue;
+
+			float bounds[2][3], centerBounds[2][3];
+			for (int i = 0; i < 3; i++)
+			{
+				bounds[0][i] = centerBounds[0][i] = std::numeric_limits<float>::max();
+				bounds[1][i] = centerBounds[1][i] = -std::numeric_limits<float>::max();
+			}
+
+			for (unsigned int i = start; i < end; i++)
+			{
+				const BuildPrimitive &primitive = primitives[i];
+				for (int j = 0; j < 3; j++)
+				{
+					bounds[0][j] = std::min(bounds[0][j], primitive.min[j]);
+					bounds[1][j] = std::max(bounds[1][j], primitive.max[j]);
+					centerBounds[0][j] = std::min(centerBounds[0][j], primitive.center[j]);
+					centerBounds[1][j] = std::max(centerBounds[1][j], primitive.center[j]);
+				}
+			}
+
+			// find the cheapest split among all axes' bins.
+			float leafCost = GetHalfArea(bounds[0], bounds[1]) * treeNode.count;
+			float bestCost = std::numeric_limits<float>::max();
+			int bestAxis = -1, bestBin = 0;
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float axisMin = centerBounds[0][axis];
+				float axisSize = centerBounds[1][axis] - axisMin;
+				if (axisSize <= 0.0f)
+					continue;
+
+				unsigned int binCounts[SAH_BIN_COUNT] = { 0 };
+				float binBounds[SAH_BIN_COUNT][2][3];
+				for (int i = 0; i < SAH_BIN_COUNT; i++)
+				{
+					for (int j = 0; j < 3; j++)
+					{
+						binBounds[i][0][j] = std::numeric_limits<float>::max();
+						binBounds[i][1][j] = -std::numeric_limits<float>::max();
+					}
+				}
+
+				float scale = SAH_BIN_COUNT / axisSize;
+				for (unsigned int i = start; i < end; i++)
+				{
+					const BuildPrimitive &primitive = primitives[i];
+					int bin = std::min((int)((primitive.center[axis] - axisMin) * scale), SAH_BIN_COUNT - 1);
+
+					binCounts[bin]++;
+					for (int j = 0; j < 3; j++)
+					{
+						binBounds[bin][0][j] = std::min(binBounds[bin][0][j], primitive.min[j]);
+						binBounds[bin][1][j] = std::max(binBounds[bin][1][j], primitive.max[j]);
+					}
+				}
+
+				// sweep from right to get the cost of every right side.
+				float rightCosts[SAH_BIN_COUNT];
+				float sweep[2][3];
+				unsigned int sweepCount = 0;
+				for (int j = 0; j < 3; j++)
+				{
+					sweep[0][j] = std::numeric_limits<float>::max();
+					sweep[1][j] = -std::numeric_limits<float>::max();
+				}
+
+				for (int i = SAH_BIN_COUNT - 1; i > 0; i--)
+				{
+					sweepCount += binCounts[i];
+					for (int j = 0; j < 3; j++)
+					{
+						sweep[0][j] = std::min(sweep[0][j], binBounds[i][0][j]);
+						sweep[1][j] = std::max(sweep[1][j], binBounds[i][1][j]);
+					}
+					rightCosts[i] = sweepCount > 0 ? GetHalfArea(sweep[0], sweep[1]) * sweepCount : 0.0f;
+				}
+
+				sweepCount = 0;
+				for (int j = 0; j < 3; j++)
+				{
+					sweep[0][j] = std::numeric_limits<float>::max();
+					sweep[1][j] = -std::numeric_limits<float>::max();
+				}
+
+				// split between bin i - 1 and bin i.
+				for (int i = 1; i < SAH_BIN_COUNT; i++)
+				{
+					sweepCount += binCounts[i - 1];
+					for (int j = 0; j < 3; j++)
+					{
+						sweep[0][j] = std::min(sweep[0][j], binBounds[i - 1][0][j]);
+						sweep[1][j] = std::max(sweep[1][j], binBounds[i - 1][1][j]);
+					}
+
+					if (sweepCount == 0 || sweepCount == treeNode.count)
+						continue;
+
+					float cost = GetHalfArea(sweep[0], sweep[1]) * sweepCount + rightCosts[i];
+					if (cost < bestCost)
+					{
+						bestCost = cost;
+						bestAxis = axis;
+						bestBin = i;
+					}
+				}
+			}
+
+			unsigned int mid = start;
+
+			if (bestAxis >= 0)
+			{
+				// internal node's traversal cost is about 1 primitive test.
+				if (bestCost + GetHalfArea(bounds[0], bounds[1]) >= leafCost && treeNode.count <= m_LeafSize * 4)
+					continue;
+
+				float axisMin = centerBounds[0][bestAxis];
+				float scale = SAH_BIN_COUNT / (centerBounds[1][bestAxis] - axisMin);
+
+				auto it = std::partition(primitives.begin() + start, primitives.begin() + end, [&](const BuildPrimitive &primitive)
+				{
+					int bin = std::min((int)((primitive.center[bestAxis] - axisMin) * scale), SAH_BIN_COUNT - 1);
+					return bin < bestBin;
+				});
+				mid = it - primitives.begin();
+			}
+
+			// all centers are the same, or the binning failed to separate them.
+			if (mid == start || mid == end)
+				mid = start + treeNode.count / 2;
+
+			// pop left first, so nodes stay in depth-first order.
+			tasks.push_back({ mid, end, index, false });
+			tasks.push_back({ start, mid, index, true });
+		}
+	}
+
+	float BVHTree::Refit()
+	{
+		m_RefitDirty = false;
+
+		if (m_TreeNodes.empty())
+			return 0.0f;
+
+		unsigned int nodeCount = m_TreeNodes.size();
+		std::vector<float> mins(nodeCount * 3), maxs(nodeCount * 3);
+
+		const float *cx = m_PrimitiveBounds.GetCenterX();
+		const float *cy = m_PrimitiveBounds.GetCenterY();
+		const float *cz = m_PrimitiveBounds.GetCenterZ();
+		const float *ex = m_PrimitiveBounds.GetExtentsX();
+		const float *ey = m_PrimitiveBounds.GetExtentsY();
+		const float *ez = m_PrimitiveBounds.GetExtentsZ();
+
+		float cost = 0.0f;
+
+		// childs always come after their parent, so walk backward.
+		for (unsigned int i = nodeCount; i-- > 0;)
+		{
+			const TreeNode &treeNode = m_TreeNodes[i];
+			float *min = &mins[i * 3];
+			float *max = &maxs[i * 3];
+
+			if (treeNode.left != INVALID_INDEX)
+			{
+				const float *leftMin = &mins[treeNode.left * 3], *leftMax = &maxs[treeNode.left * 3];
+				const float *rightMin = &mins[treeNode.right * 3], *rightMax = &maxs[treeNode.right * 3];
+				for (int j = 0; j < 3; j++)
+				{
+					min[j] = std::min(leftMin[j], rightMin[j]);
+					max[j] = std::max(leftMax[j], rightMax[j]);
+				}
+				cost += GetHalfArea(min, max);
+			}
+			else
+			{
+				for (int j = 0; j < 3; j++)
+				{
+					min[j] = std::numeric_limits<float>::max();
+					max[j] = -std::numeric_limits<float>::max();
+				}
+
+				unsigned int end = treeNode.start + treeNode.count;
+				for (unsigned int k = treeNode.start; k < end; k++)
+				{
+					min[0] = std::min(min[0], cx[k] - ex[k]);
+					min[1] = std::min(min[1], cy[k] - ey[k]);
+					min[2] = std::min(min[2], cz[k] - ez[k]);
+					max[0] = std::max(max[0], cx[k] + ex[k]);
+					max[1] = std::max(max[1], cy[k] + ey[k]);
+					max[2] = std::max(max[2], cz[k] + ez[k]);
+				}
+				cost += GetHalfArea(min, max) * treeNode.count;
+			}
+
+			m_TreeNodeBounds[i].SetMinMax(Vector4(min[0], min[1], min[2]), Vector4(max[0], max[1], max[2]));
+		}
+
+		float rootArea = GetHalfArea(&mins[0], &maxs[0]);
+		return rootArea > 0.0f ? cost / rootArea : 0.0f;
+	}
+}
\ No newline at end of file
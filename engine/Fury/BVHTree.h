@@ -0,0 +1,134 @@
+#ifndef _FURY_BVH_TREE_H_
+#define _FURY_BVH_TREE_H_
+
+#include <vector>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+
+#include "Fury/BoxBounds.h"
+#include "Fury/BoxBoundsArray.h"
+#include "Fury/SceneManager.h"
+
+namespace fury
+{
+	/**
+	 *	Bounding volume hierarchy built with surface area heuristic.
+	 *
+	 *	Insert/remove marks the tree for rebuild, moving objects only refit node bounds.
+	 *	Both happen in Flush, and a refit that degrades
+	 *	the sah cost by more than 'rebuildRatio' triggers a full rebuild.
+	 *
+	 *	Tree nodes are stored parent before child, so refit is a single reverse pass.
+	 */
+	class FURY_API BVHTree : public SceneManager, public std::enable_shared_from_this<BVHTree>
+	{
+	public:
+
+		typedef std::shared_ptr<BVHTree> Ptr;
+
+		static Ptr Create(unsigned int leafSize = 4, float rebuildRatio = 1.5f);
+
+		static const unsigned int INVALID_INDEX;
+
+	protected:
+
+		struct TreeNode
+		{
+			// childs of internal node, INVALID_INDEX for leaf.
+			unsigned int left, right;
+
+			unsigned int parent;
+
+			// primitive range of leaf node.
+			unsigned int start, count;
+		};
+
+		struct BuildPrimitive
+		{
+			float min[3], max[3], center[3];
+
+			unsigned int entry;
+		};
+
+		struct Entry
+		{
+			std::shared_ptr<SceneNode> sceneNode;
+
+			// index in m_Primitives, INVALID_INDEX if unbounded or not built yet.
+			unsigned int primitive;
+		};
+
+		std::type_index m_TypeIndex;
+
+		unsigned int m_LeafSize;
+
+		float m_RebuildRatio;
+
+		std::vector<Entry> m_Entries;
+
+		std::unordered_map<SceneNode*, unsigned int> m_EntryMap;
+
+		std::vector<TreeNode> m_TreeNodes;
+
+		std::vector<BoxBounds> m_TreeNodeBounds;
+
+		// entry indices in leaf order.
+		std::vector<unsigned int> m_Primitives;
+
+		BoxBoundsArray m_PrimitiveBounds;
+
+		// entries with infinite aabbs, they are tested without the tree.
+		std::vector<unsigned int> m_Unbounded;
+
+		float m_BuildCost = 0.0f;
+
+		bool m_RebuildDirty = false;
+
+		bool m_RefitDirty = false;
+
+	public:
+
+		BVHTree(unsigned int leafSize, float rebuildRatio);
+
+		virtual ~BVHTree();
+
+		virtual std::type_index GetTypeIndex() const;
+
+		virtual void AddSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
+
+		virtual void RemoveSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
+
+		virtual void UpdateSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
+
+		// rebuild or refit if needed.
+		virtual void Flush();
+
+		virtual void WalkScene(const Collidable &collider, const FilterFunc &filterFunc) const;
+
+		virtual void Clear();
+
+		// force a rebuild on next Flush.
+		void Rebuild();
+
+		// of the tree built by the last Flush.
+		unsigned int GetTreeNodeCount() const;
+
+		unsigned int GetSceneNodeCount() const;
+
+		// sah cost of the tree as of the last Flush, relative to root's surface area.
+		float GetCost() const;
+
+	protected:
+
+		void Build();
+
+		// build all nodes in depth-first order, childs always come after their parent.
+		void BuildNodes(std::vector<BuildPrimitive> &primitives);
+
+		// update node bounds bottom-up, returns the new sah cost.
+		float Refit();
+	};
+}
+
+#endif // _FURY_BVH_TREE_H_
\ No newline at end of file
@@ -1,6 +1,9 @@
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include "Fury/BoxBounds.h"
+#include "Fury/BoxBoundsArray.h"
 #include "Fury/SphereBounds.h"
 
 namespace fury
@@ -111,6 +114,29 @@ namespace fury
 		return (center - ClosestPoint(center)).SquareLength() <= radius2;
 	}
 
+	void BoxBounds::IsInsideFastBatch(const BoxBoundsArray &aabbs, unsigned int start, unsigned int count, unsigned char *results) const
+	{
+		if (m_Infinite)
+		{
+			std::fill(results, results + count, 1);
+			return;
+		}
+
+		const float *cx = aabbs.GetCenterX() + start;
+		const float *cy = aabbs.GetCenterY() + start;
+		const float *cz = aabbs.GetCenterZ() + start;
+		const float *ex = aabbs.GetExtentsX() + start;
+		const float *ey = aabbs.GetExtentsY() + start;
+		const float *ez = aabbs.GetExtentsZ() + start;
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			results[i] = std::abs(cx[i] - m_Center.x) <= ex[i] + m_Extents.x &&
+				std::abs(cy[i] - m_Center.y) <= ey[i] + m_Extents.y &&
+				std::abs(cz[i] - m_Center.z) <= ez[i] + m_Extents.z ? 1 : 0;
+		}
+	}
+
 	void BoxBounds::Encapsulate(const BoxBounds &aabb)
 	{
 		if (m_Infinite) return;
@@ -51,6 +51,8 @@ namespace fury
 
 		virtual bool IsInsideFast(const SphereBounds &bsphere) const;
 
+		virtual void IsInsideFastBatch(const BoxBoundsArray &aabbs, unsigned int start, unsigned int count, unsigned char *results) const;
+
 		// grow to include another aabb.
 		void Encapsulate(const BoxBounds &aabb);
 
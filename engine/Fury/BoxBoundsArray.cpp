@@ -0,0 +1,99 @@
+#include <limits>
+
+#include "Fury/BoxBounds.h"
+#include "Fury/BoxBoundsArray.h"
+
+namespace fury
+{
+	void BoxBoundsArray::Reserve(unsigned int size)
+	{
+		m_CenterX.reserve(size);
+		m_CenterY.reserve(size);
+		m_CenterZ.reserve(size);
+		m_ExtentsX.reserve(size);
+		m_ExtentsY.reserve(size);
+		m_ExtentsZ.reserve(size);
+	}
+
+	void BoxBoundsArray::Clear()
+	{
+		Resize(0);
+	}
+
+	unsigned int BoxBoundsArray::Add(const BoxBounds &aabb)
+	{
+		unsigned int index = GetSize();
+		Resize(index + 1);
+		Set(index, aabb);
+		return index;
+	}
+
+	void BoxBoundsArray::Set(unsigned int index, const BoxBounds &aabb)
+	{
+		if (aabb.GetInfinite())
+		{
+			float max = std::numeric_limits<float>::max();
+
+			m_CenterX[index] = m_CenterY[index] = m_CenterZ[index] = 0.0f;
+			m_ExtentsX[index] = m_ExtentsY[index] = m_ExtentsZ[index] = max;
+		}
+		else
+		{
+			Vector4 center = aabb.GetCenter();
+			Vector4 extents = aabb.GetExtents();
+
+			m_CenterX[index] = center.x;
+			m_CenterY[index] = center.y;
+			m_CenterZ[index] = center.z;
+
+			m_ExtentsX[index] = extents.x;
+			m_ExtentsY[index] = extents.y;
+			m_ExtentsZ[index] = extents.z;
+		}
+	}
+
+	void BoxBoundsArray::RemoveSwap(unsigned int index)
+	{
+		unsigned int last = GetSize() - 1;
+		if (index != last)
+		{
+			m_CenterX[index] = m_CenterX[last];
+			m_CenterY[index] = m_CenterY[last];
+			m_CenterZ[index] = m_CenterZ[last];
+
+			m_ExtentsX[index] = m_ExtentsX[last];
+			m_ExtentsY[index] = m_ExtentsY[last];
+			m_ExtentsZ[index] = m_ExtentsZ[last];
+		}
+		Resize(last);
+	}
+
+	void BoxBoundsArray::Resize(unsigned int size)
+	{
+		m_CenterX.resize(size);
+		m_CenterY.resize(size);
+		m_CenterZ.resize(size);
+		m_ExtentsX.resize(size);
+		m_ExtentsY.resize(size);
+		m_ExtentsZ.resize(size);
+	}
+
+	unsigned int BoxBoundsArray::GetSize() const
+	{
+		return m_CenterX.size();
+	}
+
+	BoxBounds BoxBoundsArray::GetBoxBounds(unsigned int index) const
+	{
+		if (m_ExtentsX[index] == std::numeric_limits<float>::max())
+		{
+			BoxBounds aabb;
+			aabb.SetInfinite(true);
+			return aabb;
+		}
+
+		Vector4 center(m_CenterX[index], m_CenterY[index], m_CenterZ[index]);
+		Vector4 extents(m_ExtentsX[index], m_ExtentsY[index], m_ExtentsZ[index], 0.0f);
+		return BoxBounds(center - extents, center + extents);
+	}
+}
\ No newline at end of file
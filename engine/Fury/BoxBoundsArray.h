@@ -0,0 +1,58 @@
+#ifndef _FURY_BOXBOUNDS_ARRAY_H_
+#define _FURY_BOXBOUNDS_ARRAY_H_
+
+#include <vector>
+
+#include "Fury/Macros.h"
+
+namespace fury
+{
+	class BoxBounds;
+
+	// aabbs stored as separate center/extents arrays, so collidables can test several boxes at once.
+	// infinite aabbs are stored as zero center with FLT_MAX extents.
+	class FURY_API BoxBoundsArray
+	{
+	protected:
+
+		std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+
+		std::vector<float> m_ExtentsX, m_ExtentsY, m_ExtentsZ;
+
+	public:
+
+		BoxBoundsArray() {}
+
+		void Reserve(unsigned int size);
+
+		void Clear();
+
+		// returns index of the new aabb.
+		unsigned int Add(const BoxBounds &aabb);
+
+		void Set(unsigned int index, const BoxBounds &aabb);
+
+		// moves the last aabb to index, the same way owners swap-and-pop their objects.
+		void RemoveSwap(unsigned int index);
+
+		void Resize(unsigned int size);
+
+		unsigned int GetSize() const;
+
+		BoxBounds GetBoxBounds(unsigned int index) const;
+
+		const float *GetCenterX() const { return m_CenterX.data(); }
+
+		const float *GetCenterY() const { return m_CenterY.data(); }
+
+		const float *GetCenterZ() const { return m_CenterZ.data(); }
+
+		const float *GetExtentsX() const { return m_ExtentsX.data(); }
+
+		const float *GetExtentsY() const { return m_ExtentsY.data(); }
+
+		const float *GetExtentsZ() const { return m_ExtentsZ.data(); }
+	};
+}
+
+#endif // _FURY_BOXBOUNDS_ARRAY_H_
\ No newline at end of file
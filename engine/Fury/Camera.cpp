@@ -1,3 +1,5 @@
+#include <limits>
+
 #include "Fury/Camera.h"
 #include "Fury/Plane.h"
 #include "Fury/SceneNode.h"
@@ -13,6 +15,8 @@ namespace fury
 	{
 		m_TypeIndex = typeid(Camera);
 		m_ShadowAABB = BoxBounds(Vector4(0), Vector4(0));
+		m_DrawDistances.fill(std::numeric_limits<float>::max());
+		m_MinScreenSizes.fill(0.0f);
 	}
 
 	Component::Ptr Camera::Clone() const
@@ -23,6 +27,8 @@ namespace fury
 		ptr->m_ProjectionMatrix = m_ProjectionMatrix;
 		ptr->m_Frustum = m_Frustum;
 		ptr->m_ShadowAABB = m_ShadowAABB;
+		ptr->m_DrawDistances = m_DrawDistances;
+		ptr->m_MinScreenSizes = m_MinScreenSizes;
 		return ptr;
 	}
 
@@ -171,17 +177,79 @@ namespace fury
 		return m_Frustum.IsInsideFast(point);
 	}
 
+	float Camera::GetScreenSize(const BoxBounds &aabb) const
+	{
+		if (aabb.GetInfinite())
+			return std::numeric_limits<float>::max();
+
+		float radius = aabb.GetExtents().Length();
+
+		// Raw[5] is 2 * near / height for perspective, 2 / height for ortho.
+		float scale = m_ProjectionMatrix.Raw[5];
+		if (!m_Perspective)
+			return radius * scale;
+
+		Vector4 camPos = m_Frustum.GetTransformMatrix().Multiply(Vector4(0, 0, 0, 1));
+		float distance = camPos.Distance(aabb.GetCenter());
+		if (distance <= radius)
+			return std::numeric_limits<float>::max();
+
+		return radius * scale / distance;
+	}
+
+	// index of a single category flag.
+	static unsigned int GetCategoryIndex(SceneNodeCategory category)
+	{
+		unsigned int index = 0;
+		for (unsigned int bits = (unsigned int)category; bits > 1; bits >>= 1)
+			index++;
+		return index;
+	}
+
+	void Camera::SetDrawDistance(SceneNodeCategory category, float distance)
+	{
+		m_DrawDistances[GetCategoryIndex(category)] = distance;
+	}
+
+	float Camera::GetDrawDistance(SceneNodeCategory category) const
+	{
+		return m_DrawDistances[GetCategoryIndex(category)];
+	}
+
+	void Camera::SetMinScreenSize(SceneNodeCategory category, float size)
+	{
+		m_MinScreenSizes[GetCategoryIndex(category)] = size;
+	}
+
+	float Camera::GetMinScreenSize(SceneNodeCategory category) const
+	{
+		return m_MinScreenSizes[GetCategoryIndex(category)];
+	}
+
+	Ray Camera::ScreenPointToRay(float x, float y) const
+	{
+		// corners: ntl, ntr, nbl, nbr, ftl, ftr, fbl, fbr
+		auto corners = m_Frustum.GetCurrentCorners();
+
+		auto lerp = [](Vector4 a, Vector4 b, float t) { return a + (b - a) * t; };
+
+		Vector4 nearPoint = lerp(lerp(corners[0], corners[1], x), lerp(corners[2], corners[3], x), y);
+		Vector4 farPoint = lerp(lerp(corners[4], corners[5], x), lerp(corners[6], corners[7], x), y);
+
+		return Ray(nearPoint, farPoint - nearPoint, (farPoint - nearPoint).Length());
+	}
+
 	void Camera::OnAttaching(const std::shared_ptr<SceneNode> &node)
 	{
 		Component::OnAttaching(node);
 		Camera::Ptr selfPtr = shared_from_this();
-		m_SignalKey = node->OnTransformChange->Connect(selfPtr, &Camera::OnSceneNodeTransformChange);
+		m_SignalKey = node->OnTransformChange()->Connect(selfPtr, &Camera::OnSceneNodeTransformChange);
 	}
 
 	void Camera::OnDetaching(const std::shared_ptr<SceneNode> &node)
 	{
 		Component::OnDetaching(node);
-		node->OnTransformChange->Disconnect(m_SignalKey);
+		node->OnTransformChange()->Disconnect(m_SignalKey);
 		m_SignalKey = 0;
 	}
 
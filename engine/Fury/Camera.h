@@ -5,8 +5,10 @@
 
 #include "Fury/BoxBounds.h"
 #include "Fury/Component.h"
+#include "Fury/EnumUtil.h"
 #include "Fury/Matrix4.h"
 #include "Fury/Frustum.h"
+#include "Fury/Ray.h"
 
 namespace fury
 {
@@ -29,6 +31,11 @@ namespace fury
 
 		float m_ShadowFar = 0.0f;
 
+		// one per SceneNodeCategory, by bit index.
+		std::array<float, 3> m_DrawDistances;
+
+		std::array<float, 3> m_MinScreenSizes;
+
 		size_t m_SignalKey = 0;
 
 	public:
@@ -81,6 +88,27 @@ namespace fury
 		// test the visiablity of a point.
 		bool IsVisible(Vector4 point) const;
 
+		// projected diameter of aabb's bounding sphere, as a fraction of viewport height.
+		// used to pick mesh lods, see MeshRender::GetLOD.
+		float GetScreenSize(const BoxBounds &aabb) const;
+
+		// scenenodes of category farther than distance from the camera are culled,
+		// distance is measured to the nearest point of their aabb.
+		// SHADOW_CASTER's thresholds are used by shadow passes, the others by the camera's own view.
+		void SetDrawDistance(SceneNodeCategory category, float distance);
+
+		float GetDrawDistance(SceneNodeCategory category) const;
+
+		// scenenodes of category whose aabb projects smaller than size are culled,
+		// size is a fraction of viewport height, see DetailCuller.
+		void SetMinScreenSize(SceneNodeCategory category, float size);
+
+		float GetMinScreenSize(SceneNodeCategory category) const;
+
+		// ray from near plane to far plane through a screen point, for picking.
+		// x, y are in [0, 1], from screen's top left.
+		Ray ScreenPointToRay(float x, float y) const;
+
 		// SceneNode::OnTransformChange callback.
 		void OnSceneNodeTransformChange(const std::shared_ptr<SceneNode> &sender);
 
@@ -0,0 +1,12 @@
+#include "Fury/BoxBounds.h"
+#include "Fury/BoxBoundsArray.h"
+#include "Fury/Collidable.h"
+
+namespace fury
+{
+	void Collidable::IsInsideFastBatch(const BoxBoundsArray &aabbs, unsigned int start, unsigned int count, unsigned char *results) const
+	{
+		for (unsigned int i = 0; i < count; i++)
+			results[i] = IsInsideFast(aabbs.GetBoxBounds(start + i)) ? 1 : 0;
+	}
+}
\ No newline at end of file
@@ -7,6 +7,8 @@ namespace fury
 {
 	class BoxBounds;
 
+	class BoxBoundsArray;
+
 	class SphereBounds;
 
 	class Vector4;
@@ -26,6 +28,10 @@ namespace fury
 		virtual bool IsInsideFast(const BoxBounds &aabb) const = 0;
 
 		virtual bool IsInsideFast(Vector4 point) const = 0;
+
+		// test aabbs[start, start + count) and write 1 to results[i] if the i-th aabb passes IsInsideFast.
+		// the default one tests them one by one.
+		virtual void IsInsideFastBatch(const BoxBoundsArray &aabbs, unsigned int start, unsigned int count, unsigned char *results) const;
 	};
 }
 
@@ -1,8 +1,21 @@
+#include <mutex>
+#include <unordered_map>
+
 #include "Fury/Component.h"
 #include "Fury/SceneNode.h"
 
 namespace fury
 {
+	unsigned int Component::GetTypeId(std::type_index type)
+	{
+		// function statics, ids may be asked for during static initialization.
+		static std::mutex mutex;
+		static std::unordered_map<std::type_index, unsigned int> typeIds;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		return typeIds.emplace(type, typeIds.size()).first->second;
+	}
+
 	Component::Component() : m_TypeIndex(typeid(Component)) {}
 
 	Component::~Component()
@@ -38,4 +51,8 @@ namespace fury
 	{
 		m_Owner.reset();
 	}
+
+	void Component::OnSharing(const std::shared_ptr<SceneNode> &node) {}
+
+	void Component::OnUnsharing(SceneNode &node) {}
 }
\ No newline at end of file
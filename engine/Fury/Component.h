@@ -19,6 +19,13 @@ namespace fury
 
 		typedef std::shared_ptr<Component> Ptr;
 
+		// dense id of a component type, assigned on first use.
+		// scenenodes index their components with these instead of hashing type_index.
+		static unsigned int GetTypeId(std::type_index type);
+
+		template<class ComponentType>
+		static unsigned int GetTypeId();
+
 		Component();
 
 		virtual ~Component();
@@ -27,6 +34,12 @@ namespace fury
 
 		virtual Ptr Clone() const = 0;
 
+		// components without per scenenode state, prefab instances share them instead of cloning.
+		virtual bool GetShareable() const
+		{
+			return false;
+		}
+
 		virtual bool Load(const void* wrapper, bool object = true) 
 		{
 			return true;
@@ -49,7 +62,22 @@ namespace fury
 		// this is called form owner's destructor.
 		// so don't do nasty thing in it.
 		virtual void OnOwnerDestructing(SceneNode &node);
+
+		// node shares this through a prefab instance, it's still attached to the prefab's source only.
+		// override to keep node up to date with changes that affect it, ie. it's categories.
+		virtual void OnSharing(const std::shared_ptr<SceneNode> &node);
+
+		// also called form node's destructor, same rules as OnOwnerDestructing.
+		virtual void OnUnsharing(SceneNode &node);
 	};
+
+	template<class ComponentType>
+	unsigned int Component::GetTypeId()
+	{
+		// registry is only locked by the first call for each type.
+		static const unsigned int typeId = GetTypeId(typeid(ComponentType));
+		return typeId;
+	}
 }
 
 #endif // _FURY_COMPONENT_H_
\ No newline at end of file
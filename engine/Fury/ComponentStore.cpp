@@ -0,0 +1,95 @@
+#include <limits>
+
+#include "Fury/ComponentStore.h"
+#include "Fury/ThreadUtil.h"
+
+namespace fury
+{
+	ComponentStore::Ptr ComponentStore::Active = nullptr;
+
+	const unsigned int ComponentStore::INVALID_HANDLE = std::numeric_limits<unsigned int>::max();
+
+	ComponentStore::Ptr ComponentStore::Create()
+	{
+		return std::make_shared<ComponentStore>();
+	}
+
+	unsigned int ComponentStore::Add(unsigned int typeId, const std::shared_ptr<Component> &component, SceneNode *owner)
+	{
+		if (typeId >= m_Pools.size())
+			m_Pools.resize(typeId + 1);
+
+		Pool &pool = m_Pools[typeId];
+
+		unsigned int handle;
+		if (pool.freeHandles.size() > 0)
+		{
+			handle = pool.freeHandles.back();
+			pool.freeHandles.pop_back();
+		}
+		else
+		{
+			handle = pool.indices.size();
+			pool.indices.push_back(INVALID_HANDLE);
+		}
+
+		pool.indices[handle] = pool.handles.size();
+
+		pool.handles.push_back(handle);
+		pool.components.push_back(component);
+		pool.owners.push_back(owner);
+
+		return handle;
+	}
+
+	void ComponentStore::Remove(unsigned int typeId, unsigned int handle)
+	{
+		Pool &pool = m_Pools[typeId];
+
+		unsigned int index = pool.indices[handle];
+		unsigned int last = pool.handles.size() - 1;
+
+		// move the last component to index, pools stay packed.
+		if (index != last)
+		{
+			pool.handles[index] = pool.handles[last];
+			pool.components[index] = std::move(pool.components[last]);
+			pool.owners[index] = pool.owners[last];
+
+			pool.indices[pool.handles[index]] = index;
+		}
+
+		pool.handles.pop_back();
+		pool.components.pop_back();
+		pool.owners.pop_back();
+
+		pool.indices[handle] = INVALID_HANDLE;
+		pool.freeHandles.push_back(handle);
+	}
+
+	const std::shared_ptr<Component> &ComponentStore::Get(unsigned int typeId, unsigned int handle) const
+	{
+		const Pool &pool = m_Pools[typeId];
+		return pool.components[pool.indices[handle]];
+	}
+
+	unsigned int ComponentStore::GetCount(unsigned int typeId) const
+	{
+		return typeId < m_Pools.size() ? m_Pools[typeId].components.size() : 0;
+	}
+
+	unsigned int ComponentStore::GetParallelThreshold() const
+	{
+		return m_ParallelThreshold;
+	}
+
+	void ComponentStore::SetParallelThreshold(unsigned int threshold)
+	{
+		m_ParallelThreshold = threshold;
+	}
+
+	void ComponentStore::ForRanges(unsigned int typeId, const std::function<void(unsigned int, unsigned int)> &rangeFunc) const
+	{
+		ThreadUtil::Instance()->ParallelFor(GetCount(typeId), m_ParallelThreshold, rangeFunc);
+	}
+}
\ No newline at end of file
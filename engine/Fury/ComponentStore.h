@@ -0,0 +1,132 @@
+#ifndef _FURY_COMPONENT_STORE_H_
+#define _FURY_COMPONENT_STORE_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Fury/Component.h"
+
+namespace fury
+{
+	class SceneNode;
+
+	/**
+	 *	Attached components of a scene's scenenodes, one packed pool per component type.
+	 *	Each Scene has it's own store, scenenodes move their components over when they're 
+	 *	attached below it's root node, and back to ComponentStore::Active when they're detached.
+	 *
+	 *	Scenenodes keep handles, a component's index changes when another one of it's type is removed.
+	 *	Pools are indexed by Component::GetTypeId, ForEach walks one type's components back to back,
+	 *	without visiting scenenodes that don't have one.
+	 *
+	 *	Not locked. Components are attached and detached on the main thread only, 
+	 *	that includes moving them between stores. Lookups only read the pools, so any number of threads may 
+	 *	look up components at once, ie. parallel culling filters and ray cast batches, while nothing attaches or detaches.
+	 *	ParallelForEach's visitors may use the components they're given under the same rule.
+	 */
+	class FURY_API ComponentStore
+	{
+	public:
+
+		typedef std::shared_ptr<ComponentStore> Ptr;
+
+		// scenenodes outside of scenes, ie. prefab sources and detached nodes. created by the first scenenode.
+		static Ptr Active;
+
+		static Ptr Create();
+
+		static const unsigned int INVALID_HANDLE;
+
+	protected:
+
+		struct Pool
+		{
+			// handle -> index, INVALID_HANDLE for free handles.
+			std::vector<unsigned int> indices;
+
+			std::vector<unsigned int> freeHandles;
+
+			// everything below is indexed by index.
+
+			std::vector<unsigned int> handles;
+
+			std::vector<std::shared_ptr<Component>> components;
+
+			std::vector<SceneNode*> owners;
+		};
+
+		std::vector<Pool> m_Pools;
+
+		// pools with less components are walked on the calling thread.
+		unsigned int m_ParallelThreshold = 1024;
+
+	public:
+
+		unsigned int Add(unsigned int typeId, const std::shared_ptr<Component> &component, SceneNode *owner);
+
+		void Remove(unsigned int typeId, unsigned int handle);
+
+		// only reads, never grows or repacks a pool, so it's safe from several threads while nothing attaches.
+		const std::shared_ptr<Component> &Get(unsigned int typeId, unsigned int handle) const;
+
+		unsigned int GetCount(unsigned int typeId) const;
+
+		template<class ComponentType>
+		unsigned int GetCount() const;
+
+		unsigned int GetParallelThreshold() const;
+
+		void SetParallelThreshold(unsigned int threshold);
+
+		// visitor is called with ComponentType& and it's owner SceneNode&, in pool order.
+		// don't attach or detach components of ComponentType while visiting.
+		template<class ComponentType, class Visitor>
+		void ForEach(Visitor &&visitor) const;
+
+		// ForEach split into chunks on ThreadUtil's workers, visitor must be thread safe.
+		// components of one chunk are visited in pool order on one thread.
+		template<class ComponentType, class Visitor>
+		void ParallelForEach(Visitor &&visitor) const;
+
+	protected:
+
+		// calls rangeFunc with [start, end) chunks of typeId's pool, on workers if the pool is large enough.
+		void ForRanges(unsigned int typeId, const std::function<void(unsigned int, unsigned int)> &rangeFunc) const;
+	};
+
+	template<class ComponentType>
+	unsigned int ComponentStore::GetCount() const
+	{
+		return GetCount(Component::GetTypeId<ComponentType>());
+	}
+
+	template<class ComponentType, class Visitor>
+	void ComponentStore::ForEach(Visitor &&visitor) const
+	{
+		unsigned int typeId = Component::GetTypeId<ComponentType>();
+		if (typeId >= m_Pools.size())
+			return;
+
+		const Pool &pool = m_Pools[typeId];
+		for (unsigned int i = 0; i < pool.components.size(); i++)
+			visitor(static_cast<ComponentType&>(*pool.components[i]), *pool.owners[i]);
+	}
+
+	template<class ComponentType, class Visitor>
+	void ComponentStore::ParallelForEach(Visitor &&visitor) const
+	{
+		unsigned int typeId = Component::GetTypeId<ComponentType>();
+		if (typeId >= m_Pools.size())
+			return;
+
+		const Pool &pool = m_Pools[typeId];
+		ForRanges(typeId, [&](unsigned int start, unsigned int end)
+		{
+			for (unsigned int i = start; i < end; i++)
+				visitor(static_cast<ComponentType&>(*pool.components[i]), *pool.owners[i]);
+		});
+	}
+}
+
+#endif // _FURY_COMPONENT_STORE_H_
\ No newline at end of file
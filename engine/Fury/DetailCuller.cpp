@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Fury/BoxBounds.h"
+#include "Fury/BoxBoundsArray.h"
+#include "Fury/Camera.h"
+#include "Fury/DetailCuller.h"
+#include "Fury/SphereBounds.h"
+
+namespace fury
+{
+	DetailCuller::DetailCuller(const Collidable &collider, const Camera &camera, unsigned int categories) :
+		m_Collider(collider), m_DrawDistance(std::numeric_limits<float>::max())
+	{
+		float drawDistance = 0.0f;
+		float minScreenSize = std::numeric_limits<float>::max();
+		bool found = false;
+
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			if ((categories & (1 << i)) == 0)
+				continue;
+
+			auto category = (SceneNodeCategory)(1 << i);
+			drawDistance = std::max(drawDistance, camera.GetDrawDistance(category));
+			minScreenSize = std::min(minScreenSize, camera.GetMinScreenSize(category));
+			found = true;
+		}
+
+		if (!found)
+			return;
+
+		m_DrawDistance = drawDistance;
+		m_MinScreenSize = minScreenSize;
+		m_Enabled = m_DrawDistance < std::numeric_limits<float>::max() || m_MinScreenSize > 0.0f;
+
+		m_CamPos = camera.GetFrustum().GetTransformMatrix().Multiply(Vector4(0.0f, 0.0f, 0.0f, 1.0f));
+		m_Perspective = camera.IsPerspective();
+		m_ProjectionScale = camera.GetProjectionMatrix().Raw[5];
+	}
+
+	const Collidable &DetailCuller::GetCollider() const
+	{
+		return m_Collider;
+	}
+
+	bool DetailCuller::GetEnabled() const
+	{
+		return m_Enabled;
+	}
+
+	bool DetailCuller::IsDetailed(float distance, float radius) const
+	{
+		if (distance > m_DrawDistance)
+			return false;
+
+		if (m_MinScreenSize <= 0.0f)
+			return true;
+
+		// radius * scale / distance >= min, without dividing by zero distance.
+		if (m_Perspective)
+			return radius * m_ProjectionScale >= m_MinScreenSize * distance;
+		else
+			return radius * m_ProjectionScale >= m_MinScreenSize;
+	}
+
+	Side DetailCuller::IsInside(Vector4 point) const
+	{
+		if (m_Enabled && !IsDetailed(m_CamPos.Distance(point), 0.0f))
+			return Side::OUT;
+
+		return m_Collider.IsInside(point);
+	}
+
+	Side DetailCuller::IsInside(const BoxBounds &aabb) const
+	{
+		if (!m_Enabled)
+			return m_Collider.IsInside(aabb);
+
+		if (!IsDetailed(aabb))
+			return Side::OUT;
+
+		// contents of a tree node inside the collider may still be too small or too far.
+		Side side = m_Collider.IsInside(aabb);
+		if (side == Side::IN && !IsFullyDetailed(aabb))
+			side = Side::STRADDLE;
+
+		return side;
+	}
+
+	Side DetailCuller::IsInside(const SphereBounds &bsphere) const
+	{
+		if (!m_Enabled)
+			return m_Collider.IsInside(bsphere);
+
+		if (!IsDetailed(bsphere))
+			return Side::OUT;
+
+		Side side = m_Collider.IsInside(bsphere);
+		if (side == Side::IN && !bsphere.GetInfinite())
+		{
+			float radius = bsphere.GetRadius();
+			Vector4 extents(radius, radius, radius, 0.0f);
+			if (!IsFullyDetailed(BoxBounds(bsphere.GetCenter() - extents, bsphere.GetCenter() + extents)))
+				side = Side::STRADDLE;
+		}
+
+		return side;
+	}
+
+	bool DetailCuller::IsInsideFast(const SphereBounds &bsphere) const
+	{
+		if (m_Enabled && !IsDetailed(bsphere))
+			return false;
+
+		return m_Collider.IsInsideFast(bsphere);
+	}
+
+	bool DetailCuller::IsInsideFast(const BoxBounds &aabb) const
+	{
+		if (m_Enabled && !IsDetailed(aabb))
+			return false;
+
+		return m_Collider.IsInsideFast(aabb);
+	}
+
+	bool DetailCuller::IsInsideFast(Vector4 point) const
+	{
+		if (m_Enabled && !IsDetailed(m_CamPos.Distance(point), 0.0f))
+			return false;
+
+		return m_Collider.IsInsideFast(point);
+	}
+
+	void DetailCuller::IsInsideFastBatch(const BoxBoundsArray &aabbs, unsigned int start, unsigned int count, unsigned char *results) const
+	{
+		m_Collider.IsInsideFastBatch(aabbs, start, count, results);
+
+		if (!m_Enabled)
+			return;
+
+		const float *centerX = aabbs.GetCenterX(), *centerY = aabbs.GetCenterY(), *centerZ = aabbs.GetCenterZ();
+		const float *extentsX = aabbs.GetExtentsX(), *extentsY = aabbs.GetExtentsY(), *extentsZ = aabbs.GetExtentsZ();
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (results[i] == 0)
+				continue;
+
+			// infinite aabbs have FLT_MAX extents, so they are always at distance 0.
+			unsigned int index = start + i;
+			float dx = std::max(std::abs(m_CamPos.x - centerX[index]) - extentsX[index], 0.0f);
+			float dy = std::max(std::abs(m_CamPos.y - centerY[index]) - extentsY[index], 0.0f);
+			float dz = std::max(std::abs(m_CamPos.z - centerZ[index]) - extentsZ[index], 0.0f);
+
+			float radius = std::sqrt(extentsX[index] * extentsX[index] + extentsY[index] * extentsY[index] + extentsZ[index] * extentsZ[index]);
+			results[i] = IsDetailed(std::sqrt(dx * dx + dy * dy + dz * dz), radius) ? 1 : 0;
+		}
+	}
+
+	bool DetailCuller::IsDetailed(const BoxBounds &aabb) const
+	{
+		if (aabb.GetInfinite())
+			return true;
+
+		return IsDetailed(aabb.GetDistance(m_CamPos), aabb.GetExtents().Length());
+	}
+
+	bool DetailCuller::IsDetailed(const SphereBounds &bsphere) const
+	{
+		if (bsphere.GetInfinite())
+			return true;
+
+		float radius = bsphere.GetRadius();
+		return IsDetailed(std::max(m_CamPos.Distance(bsphere.GetCenter()) - radius, 0.0f), radius);
+	}
+
+	bool DetailCuller::IsFullyDetailed(const BoxBounds &aabb) const
+	{
+		if (m_MinScreenSize > 0.0f)
+			return false;
+
+		if (aabb.GetInfinite())
+			return false;
+
+		// distance to the farthest corner.
+		Vector4 min = aabb.GetMin(), max = aabb.GetMax();
+		float dx = std::max(std::abs(m_CamPos.x - min.x), std::abs(m_CamPos.x - max.x));
+		float dy = std::max(std::abs(m_CamPos.y - min.y), std::abs(m_CamPos.y - max.y));
+		float dz = std::max(std::abs(m_CamPos.z - min.z), std::abs(m_CamPos.z - max.z));
+
+		return std::sqrt(dx * dx + dy * dy + dz * dz) <= m_DrawDistance;
+	}
+}
\ No newline at end of file
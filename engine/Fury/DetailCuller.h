@@ -0,0 +1,78 @@
+#ifndef _FURY_DETAIL_CULLER_H_
+#define _FURY_DETAIL_CULLER_H_
+
+#include "Fury/Collidable.h"
+#include "Fury/Vector4.h"
+
+namespace fury
+{
+	class Camera;
+
+	/**
+	 *	Wraps a collidable, and also rejects aabbs that are too far or too small on screen,
+	 *	by a camera's draw distances and min screen sizes of some scenenode categories.
+	 *
+	 *	Distance is measured from the camera to the nearest point of an aabb,
+	 *	screen size is the aabb's bounding sphere projected at that distance.
+	 *	Both only shrink for aabbs inside another one, so a rejected tree node rejects it's whole subtree.
+	 *
+	 *	With several categories the most permissive thresholds are used.
+	 *	The wrapped collidable is kept by reference, it must outlive the culler.
+	 */
+	class FURY_API DetailCuller : public Collidable
+	{
+	protected:
+
+		const Collidable &m_Collider;
+
+		Vector4 m_CamPos;
+
+		bool m_Perspective = true;
+
+		// projection matrix's Raw[5], 2 * near / height for perspective, 2 / height for ortho.
+		float m_ProjectionScale = 1.0f;
+
+		float m_DrawDistance;
+
+		float m_MinScreenSize = 0.0f;
+
+		bool m_Enabled = false;
+
+	public:
+
+		DetailCuller(const Collidable &collider, const Camera &camera, unsigned int categories);
+
+		const Collidable &GetCollider() const;
+
+		// false if thresholds of the categories never cull anything.
+		bool GetEnabled() const;
+
+		// distance is to the nearest point of a bounding volume, radius is it's bounding sphere's.
+		bool IsDetailed(float distance, float radius) const;
+
+		virtual Side IsInside(Vector4 point) const;
+
+		virtual Side IsInside(const BoxBounds &aabb) const;
+
+		virtual Side IsInside(const SphereBounds &bsphere) const;
+
+		virtual bool IsInsideFast(const SphereBounds &bsphere) const;
+
+		virtual bool IsInsideFast(const BoxBounds &aabb) const;
+
+		virtual bool IsInsideFast(Vector4 point) const;
+
+		virtual void IsInsideFastBatch(const BoxBoundsArray &aabbs, unsigned int start, unsigned int count, unsigned char *results) const;
+
+	protected:
+
+		bool IsDetailed(const BoxBounds &aabb) const;
+
+		bool IsDetailed(const SphereBounds &bsphere) const;
+
+		// true if every aabb inside this one passes the thresholds.
+		bool IsFullyDetailed(const BoxBounds &aabb) const;
+	};
+}
+
+#endif // _FURY_DETAIL_CULLER_H_
\ No newline at end of file
@@ -31,7 +31,7 @@ namespace fury
 
 		size_t GetHashCode() const;
 
-		size_t SetName(const std::string &name);
+		virtual size_t SetName(const std::string &name);
 
 	protected:
 
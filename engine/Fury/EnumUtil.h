@@ -156,6 +156,14 @@ namespace fury
 		LINE_STRIP
 	};
 
+	// counted per octree subtree, so queries can skip subtrees without matching scenenodes.
+	enum class SceneNodeCategory : unsigned int
+	{
+		LIGHT			= 0x0001, 
+		RENDERABLE		= 0x0002, 
+		SHADOW_CASTER	= 0x0004
+	};
+
 	class FURY_API EnumUtil final
 	{
 	private:
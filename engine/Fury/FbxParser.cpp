@@ -98,7 +98,8 @@ namespace fury
 					for (int i = 0; i < fbxRootNode->GetChildCount(); i++)
 						LoadNode(rootNode, fbxRootNode->GetChild(i));
 
-					rootNode->Recompose();
+					// one pass over the imported hierarchy, nodes are left dirty while it's built.
+					rootNode->Recompose(true);
 				}
 
 				// load animation data
@@ -1021,7 +1022,6 @@ namespace fury
 		ntNode->SetLocalPosition(furyT);
 		ntNode->SetLocalRoattion(furyR);
 		ntNode->SetLocalScale(furyS);
-		ntNode->Recompose();
 	}
 }
 
@@ -1,6 +1,15 @@
 #include <cmath>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FURY_FRUSTUM_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FURY_FRUSTUM_SSE2
+#endif
+
 #include "Fury/BoxBounds.h"
+#include "Fury/BoxBoundsArray.h"
 #include "Fury/Frustum.h"
 #include "Fury/Matrix4.h"
 #include "Fury/Plane.h"
@@ -165,6 +174,98 @@ namespace fury
 		return true;
 	}
 
+	void Frustum::IsInsideFastBatch(const BoxBoundsArray &aabbs, unsigned int start, unsigned int count, unsigned char *results) const
+	{
+		// an aabb is outside a plane when it's p-vertex is, 
+		// dist(p-vertex) = dot(normal, center) + dot(abs(normal), extents) + distance.
+		float normals[6][3], absNormals[6][3], distances[6];
+		for (int i = 0; i < 6; i++)
+		{
+			Vector4 normal = m_Planes[i].GetNormal();
+			normals[i][0] = normal.x;
+			normals[i][1] = normal.y;
+			normals[i][2] = normal.z;
+			absNormals[i][0] = std::abs(normal.x);
+			absNormals[i][1] = std::abs(normal.y);
+			absNormals[i][2] = std::abs(normal.z);
+			distances[i] = m_Planes[i].GetDistance();
+		}
+
+		const float *cx = aabbs.GetCenterX() + start;
+		const float *cy = aabbs.GetCenterY() + start;
+		const float *cz = aabbs.GetCenterZ() + start;
+		const float *ex = aabbs.GetExtentsX() + start;
+		const float *ey = aabbs.GetExtentsY() + start;
+		const float *ez = aabbs.GetExtentsZ() + start;
+
+		unsigned int i = 0;
+
+#if defined(FURY_FRUSTUM_AVX)
+		const __m256 zero = _mm256_setzero_ps();
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 centerX = _mm256_loadu_ps(cx + i), centerY = _mm256_loadu_ps(cy + i), centerZ = _mm256_loadu_ps(cz + i);
+			__m256 extentsX = _mm256_loadu_ps(ex + i), extentsY = _mm256_loadu_ps(ey + i), extentsZ = _mm256_loadu_ps(ez + i);
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+			for (int j = 0; j < 6; j++)
+			{
+				__m256 dist = _mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(_mm256_set1_ps(normals[j][0]), centerX),
+					_mm256_mul_ps(_mm256_set1_ps(normals[j][1]), centerY)), _mm256_add_ps(
+					_mm256_mul_ps(_mm256_set1_ps(normals[j][2]), centerZ), _mm256_set1_ps(distances[j])));
+				__m256 radius = _mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(_mm256_set1_ps(absNormals[j][0]), extentsX),
+					_mm256_mul_ps(_mm256_set1_ps(absNormals[j][1]), extentsY)),
+					_mm256_mul_ps(_mm256_set1_ps(absNormals[j][2]), extentsZ));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(dist, radius), zero, _CMP_GE_OQ));
+			}
+
+			int mask = _mm256_movemask_ps(inside);
+			for (int k = 0; k < 8; k++)
+				results[i + k] = (mask >> k) & 1;
+		}
+#elif defined(FURY_FRUSTUM_SSE2)
+		const __m128 zero = _mm_setzero_ps();
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 centerX = _mm_loadu_ps(cx + i), centerY = _mm_loadu_ps(cy + i), centerZ = _mm_loadu_ps(cz + i);
+			__m128 extentsX = _mm_loadu_ps(ex + i), extentsY = _mm_loadu_ps(ey + i), extentsZ = _mm_loadu_ps(ez + i);
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+			for (int j = 0; j < 6; j++)
+			{
+				__m128 dist = _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(_mm_set1_ps(normals[j][0]), centerX),
+					_mm_mul_ps(_mm_set1_ps(normals[j][1]), centerY)), _mm_add_ps(
+					_mm_mul_ps(_mm_set1_ps(normals[j][2]), centerZ), _mm_set1_ps(distances[j])));
+				__m128 radius = _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(_mm_set1_ps(absNormals[j][0]), extentsX),
+					_mm_mul_ps(_mm_set1_ps(absNormals[j][1]), extentsY)),
+					_mm_mul_ps(_mm_set1_ps(absNormals[j][2]), extentsZ));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, radius), zero));
+			}
+
+			int mask = _mm_movemask_ps(inside);
+			for (int k = 0; k < 4; k++)
+				results[i + k] = (mask >> k) & 1;
+		}
+#endif
+
+		// scalar tail, or everything on other platforms.
+		for (; i < count; i++)
+		{
+			unsigned char inside = 1;
+			for (int j = 0; j < 6 && inside; j++)
+			{
+				float dist = normals[j][0] * cx[i] + normals[j][1] * cy[i] + normals[j][2] * cz[i] + distances[j];
+				float radius = absNormals[j][0] * ex[i] + absNormals[j][1] * ey[i] + absNormals[j][2] * ez[i];
+				inside = dist + radius >= 0.0f ? 1 : 0;
+			}
+			results[i] = inside;
+		}
+	}
+
 	std::array<Vector4, 8> Frustum::GetCurrentCorners() const
 	{
 		return m_CurrentCorners;
@@ -52,6 +52,9 @@ namespace fury
 
 		virtual bool IsInsideFast(Vector4 point) const;
 
+		// tests 8 (avx) or 4 (sse2) aabbs per step against all 6 planes.
+		virtual void IsInsideFastBatch(const BoxBoundsArray &aabbs, unsigned int start, unsigned int count, unsigned char *results) const;
+
 		// ntl, ntr, nbl, nbr, ftl, ftr, fbl, fbr
 		std::array<Vector4, 8> GetCurrentCorners() const;
 
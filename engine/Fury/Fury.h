@@ -8,8 +8,11 @@
 #include "Fury/BoxBounds.h"
 #include "Fury/Buffer.h"
 #include "Fury/BufferManager.h"
+#include "Fury/BVHTree.h"
 #include "Fury/Camera.h"
 #include "Fury/Component.h"
+#include "Fury/ComponentStore.h"
+#include "Fury/DetailCuller.h"
 #include "Fury/Color.h"
 #include "Fury/Collidable.h"
 #include "Fury/Engine.h"
@@ -23,6 +26,7 @@
 #include "Fury/Joint.h"
 #include "Fury/Light.h"
 #include "Fury/Log.h"
+#include "Fury/LooseOcTree.h"
 #include "Fury/MathUtil.h"
 #include "Fury/Material.h"
 #include "Fury/Matrix4.h"
@@ -31,8 +35,11 @@
 #include "Fury/MeshUtil.h"
 #include "Fury/OcTree.h"
 #include "Fury/OcTreeNode.h"
+#include "Fury/OcclusionCuller.h"
 #include "Fury/Plane.h"
+#include "Fury/Prefab.h"
 #include "Fury/Quaternion.h"
+#include "Fury/Ray.h"
 #include "Fury/Pass.h"
 #include "Fury/Pipeline.h"
 #include "Fury/PrelightPipeline.h"
@@ -40,16 +47,21 @@
 #include "Fury/RenderUtil.h"
 #include "Fury/Scene.h"
 #include "Fury/SceneNode.h"
+#include "Fury/SceneNodeIndex.h"
 #include "Fury/Serializable.h"
 #include "Fury/Signal.h"
 #include "Fury/Shader.h"
 #include "Fury/Singleton.h"
+#include "Fury/SpatialHashGrid.h"
 #include "Fury/SphereBounds.h"
 #include "Fury/Texture.h"
 #include "Fury/ThreadUtil.h"
 #include "Fury/Transform.h"
+#include "Fury/TransformSystem.h"
+#include "Fury/TriangleBVH.h"
 #include "Fury/TypeComparable.h"
 #include "Fury/Uniform.h"
 #include "Fury/Vector4.h"
+#include "Fury/VisibilityCache.h"
 
 #endif // _FURY_FURY_H_
\ No newline at end of file
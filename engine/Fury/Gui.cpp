@@ -458,6 +458,10 @@ namespace fury
 				ImGui::Checkbox("Use Cascaded Shadow Map", &use_csm);
 				Pipeline::Active->SetSwitch(PipelineSwitch::CASCADED_SHADOW_MAP, use_csm);
 
+				static bool use_occlusion = Pipeline::Active->IsSwitchOn(PipelineSwitch::OCCLUSION_CULLING);
+				ImGui::Checkbox("Use Occlusion Culling", &use_occlusion);
+				Pipeline::Active->SetSwitch(PipelineSwitch::OCCLUSION_CULLING, use_occlusion);
+
 				ImGui::Separator();
 
 				ImGui::Checkbox("Show GBuffer Window", &showGBufferWindow);
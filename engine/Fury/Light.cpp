@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "Fury/Log.h"
 #include "Fury/Light.h"
 #include "Fury/Mesh.h"
@@ -103,6 +105,7 @@ namespace fury
 		ptr->m_OutterAngle = m_OutterAngle;
 		ptr->m_Falloff = m_Falloff;
 		ptr->m_Radius = m_Radius;
+		ptr->m_CastShadows = m_CastShadows;
 		ptr->m_AABB = m_AABB;
 		return ptr;
 	}
@@ -115,6 +118,7 @@ namespace fury
 	void Light::SetType(LightType type)
 	{
 		m_Type = type;
+		CalculateAABB();
 	}
 
 	void Light::SetColor(Color color)
@@ -150,6 +154,7 @@ namespace fury
 	void Light::SetOutterAngle(float value)
 	{
 		m_OutterAngle = value;
+		CalculateAABB();
 	}
 
 	float Light::GetOutterAngle() const
@@ -170,6 +175,7 @@ namespace fury
 	void Light::SetRadius(float value)
 	{
 		m_Radius = value;
+		CalculateAABB();
 	}
 
 	float Light::GetRadius() const
@@ -208,6 +214,12 @@ namespace fury
 			float topR = std::tan(m_OutterAngle * 0.5f) * height;
 			m_AABB.SetMinMax(Vector4(-topR, -height, -topR), Vector4(topR, 0.0f, topR));
 		}
+
+		if (auto owner = m_Owner.lock())
+			owner->SetModelAABB(m_AABB);
+
+		for (auto node : m_SharingNodes)
+			node->SetModelAABB(m_AABB);
 	}
 
 	std::shared_ptr<Mesh> Light::GetMesh()
@@ -256,4 +268,20 @@ namespace fury
 		Component::OnDetaching(node);
 		node->SetModelAABB(BoxBounds());
 	}
+
+	void Light::OnSharing(const std::shared_ptr<SceneNode> &node)
+	{
+		m_SharingNodes.push_back(node.get());
+	}
+
+	void Light::OnUnsharing(SceneNode &node)
+	{
+		// instances are mostly destroyed in reverse order.
+		auto it = std::find(m_SharingNodes.rbegin(), m_SharingNodes.rend(), &node);
+		if (it != m_SharingNodes.rend())
+		{
+			*it = m_SharingNodes.back();
+			m_SharingNodes.pop_back();
+		}
+	}
 }
\ No newline at end of file
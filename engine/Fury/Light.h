@@ -1,6 +1,8 @@
 #ifndef _FURY_LIGHT_H_
 #define _FURY_LIGHT_H_
 
+#include <vector>
+
 #include "Fury/Component.h"
 #include "Fury/BoxBounds.h"
 #include "Fury/Color.h"
@@ -41,6 +43,9 @@ namespace fury
 
 		std::shared_ptr<Mesh> m_Mesh;
 
+		// prefab instances sharing this, they unshare before they're destroyed.
+		std::vector<SceneNode*> m_SharingNodes;
+
 	public:
 
 		Light();
@@ -51,6 +56,11 @@ namespace fury
 
 		Component::Ptr Clone() const override;
 
+		bool GetShareable() const override
+		{
+			return true;
+		}
+
 		LightType GetType() const;
 
 		void SetType(LightType type);
@@ -87,6 +97,8 @@ namespace fury
 
 		BoxBounds GetAABB() const;
 
+		// also sets the model aabb of the owner and of prefab instances sharing this.
+		// type, outter angle and radius setters call it.
 		void CalculateAABB();
 
 		// Convex Volume that defines light's shape.
@@ -100,6 +112,10 @@ namespace fury
 		virtual void OnAttaching(const std::shared_ptr<SceneNode> &node) override;
 
 		virtual void OnDetaching(const std::shared_ptr<SceneNode> &node) override;
+
+		virtual void OnSharing(const std::shared_ptr<SceneNode> &node) override;
+
+		virtual void OnUnsharing(SceneNode &node) override;
 	};
 }
 
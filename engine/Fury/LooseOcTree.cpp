@@ -0,0 +1,398 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Fury/Collidable.h"
+#include "Fury/LooseOcTree.h"
+#include "Fury/SceneNode.h"
+#include "Fury/Log.h"
+
+namespace fury
+{
+	const unsigned int LooseOcTree::INVALID_INDEX = 0xffffffff;
+
+	LooseOcTree::Ptr LooseOcTree::Create(Vector4 min, Vector4 max, unsigned int maxDepth, float looseness)
+	{
+		return std::make_shared<LooseOcTree>(min, max, maxDepth, looseness);
+	}
+
+	LooseOcTree::LooseOcTree(Vector4 min, Vector4 max, unsigned int maxDepth, float looseness) :
+		m_TypeIndex(typeid(LooseOcTree)), m_MaxDepth(maxDepth), m_Looseness(std::max(looseness, 1.0f))
+	{
+		CreateTreeNode(INVALID_INDEX, min, max);
+	}
+
+	LooseOcTree::~LooseOcTree()
+	{
+		Clear();
+		FURYD << "LooseOcTree::~LooseOcTree";
+	}
+
+	std::type_index LooseOcTree::GetTypeIndex() const
+	{
+		return m_TypeIndex;
+	}
+
+	void LooseOcTree::AddSceneNode(const SceneNode::Ptr &sceneNode)
+	{
+		if (m_EntryMap.find(sceneNode.get()) != m_EntryMap.end())
+		{
+			UpdateSceneNode(sceneNode);
+			return;
+		}
+
+		unsigned int entryIndex = m_Entries.size();
+
+		Entry entry;
+		entry.sceneNode = sceneNode;
+		entry.treeNode = INVALID_INDEX;
+		entry.packedIndex = INVALID_INDEX;
+
+		m_Entries.push_back(entry);
+		m_EntryMap.emplace(sceneNode.get(), entryIndex);
+
+		SetSceneManager(*sceneNode, shared_from_this());
+		AddToTreeNode(entryIndex, GetFitTreeNode(sceneNode->GetWorldAABB()));
+		RecordChange(sceneNode.get(), false);
+	}
+
+	void LooseOcTree::RemoveSceneNode(const SceneNode::Ptr &sceneNode)
+	{
+		auto it = m_EntryMap.find(sceneNode.get());
+		if (it == m_EntryMap.end())
+			return;
+
+		unsigned int entryIndex = it->second;
+		m_EntryMap.erase(it);
+
+		RemoveFromTreeNode(entryIndex);
+		SetSceneManager(*sceneNode, nullptr);
+		RecordChange(sceneNode.get(), true);
+
+		// swap with the last entry, so m_Entries stays contiguous.
+		unsigned int lastIndex = m_Entries.size() - 1;
+		if (entryIndex != lastIndex)
+		{
+			m_Entries[entryIndex] = std::move(m_Entries[lastIndex]);
+			m_EntryMap[m_Entries[entryIndex].sceneNode.get()] = entryIndex;
+		}
+		m_Entries.pop_back();
+
+		m_PackDirty = true;
+	}
+
+	void LooseOcTree::UpdateSceneNode(const SceneNode::Ptr &sceneNode)
+	{
+		auto it = m_EntryMap.find(sceneNode.get());
+		if (it == m_EntryMap.end())
+		{
+			AddSceneNode(sceneNode);
+			return;
+		}
+
+		RecordChange(sceneNode.get(), false);
+
+		unsigned int entryIndex = it->second;
+		const BoxBounds &aabb = sceneNode->GetWorldAABB();
+		unsigned int fitNode = GetFitTreeNode(aabb);
+
+		Entry &entry = m_Entries[entryIndex];
+		if (fitNode == entry.treeNode)
+		{
+			// still in the same cell, only the cached bounds changes.
+			if (!m_PackDirty)
+				m_PackedBounds.Set(entry.packedIndex, aabb);
+			return;
+		}
+
+		RemoveFromTreeNode(entryIndex);
+		AddToTreeNode(entryIndex, fitNode);
+	}
+
+	void LooseOcTree::Flush()
+	{
+		if (m_PackDirty)
+			PackEntries();
+	}
+
+	void LooseOcTree::WalkScene(const Collidable &collider, const FilterFunc &filterFunc) const
+	{
+		// object ranges are stale until the next Flush.
+		if (m_PackDirty)
+		{
+			for (auto &entry : m_Entries)
+			{
+				if (collider.IsInsideFast(entry.sceneNode->GetWorldAABB()))
+					filterFunc(entry.sceneNode);
+			}
+			return;
+		}
+
+		using TreeNodePair = std::pair<bool, unsigned int>;
+
+		std::vector<TreeNodePair> possiblePairs;
+		possiblePairs.reserve(8 * (m_MaxDepth + 1));
+		possiblePairs.push_back(std::make_pair(false, 0));
+
+		std::vector<unsigned char> results;
+
+		while (!possiblePairs.empty())
+		{
+			TreeNodePair currentPair = possiblePairs.back();
+			possiblePairs.pop_back();
+
+			bool tested = currentPair.first;
+			const TreeNode &treeNode = m_TreeNodes[currentPair.second];
+
+			if (treeNode.totalCount == 0)
+				continue;
+
+			// root holds everything that doesn't fit, so it's objects can lie outside it's bounds.
+			if (!tested && treeNode.parent != INVALID_INDEX)
+			{
+				Side result = collider.IsInside(m_TreeNodeBounds[currentPair.second]);
+				if (result == Side::OUT)
+					continue;
+				else if (result == Side::IN)
+					tested = true;
+			}
+
+			if (tested)
+			{
+				unsigned int end = treeNode.objectStart + treeNode.objectCount;
+				for (unsigned int i = treeNode.objectStart; i < end; i++)
+					filterFunc(m_Entries[m_PackedEntries[i]].sceneNode);
+			}
+			else if (treeNode.objectCount > 0)
+			{
+				results.resize(treeNode.objectCount);
+				collider.IsInsideFastBatch(m_PackedBounds, treeNode.objectStart, treeNode.objectCount, results.data());
+
+				for (unsigned int i = 0; i < treeNode.objectCount; i++)
+				{
+					if (results[i])
+						filterFunc(m_Entries[m_PackedEntries[treeNode.objectStart + i]].sceneNode);
+				}
+			}
+
+			for (int i = 0; i < 8; i++)
+			{
+				unsigned int child = treeNode.childs[i];
+				if (child != INVALID_INDEX && m_TreeNodes[child].totalCount > 0)
+					possiblePairs.push_back(std::make_pair(tested, child));
+			}
+		}
+	}
+
+	void LooseOcTree::Reset(Vector4 min, Vector4 max, unsigned int maxDepth)
+	{
+		m_MaxDepth = maxDepth;
+
+		m_TreeNodes.clear();
+		m_TreeNodeBounds.clear();
+		CreateTreeNode(INVALID_INDEX, min, max);
+
+		for (unsigned int i = 0; i < m_Entries.size(); i++)
+		{
+			m_Entries[i].treeNode = INVALID_INDEX;
+			AddToTreeNode(i, GetFitTreeNode(m_Entries[i].sceneNode->GetWorldAABB()));
+		}
+
+		m_PackDirty = true;
+	}
+
+	void LooseOcTree::Clear()
+	{
+		for (auto &entry : m_Entries)
+			SetSceneManager(*entry.sceneNode, nullptr);
+
+		m_Entries.clear();
+		m_EntryMap.clear();
+		m_PackedEntries.clear();
+		m_PackedBounds.Clear();
+		m_PackDirty = false;
+
+		// keep the root only.
+		m_TreeNodes.resize(1);
+		m_TreeNodeBounds.resize(1);
+
+		TreeNode &root = m_TreeNodes[0];
+		std::fill(root.childs, root.childs + 8, INVALID_INDEX);
+		root.objectStart = root.objectCount = root.totalCount = 0;
+
+		RecordReset();
+	}
+
+	unsigned int LooseOcTree::GetTreeNodeCount() const
+	{
+		return m_TreeNodes.size();
+	}
+
+	unsigned int LooseOcTree::GetSceneNodeCount() const
+	{
+		return m_Entries.size();
+	}
+
+	unsigned int LooseOcTree::CreateTreeNode(unsigned int parent, Vector4 min, Vector4 max)
+	{
+		TreeNode treeNode;
+
+		treeNode.center[0] = (min.x + max.x) * 0.5f;
+		treeNode.center[1] = (min.y + max.y) * 0.5f;
+		treeNode.center[2] = (min.z + max.z) * 0.5f;
+
+		treeNode.extents[0] = (max.x - min.x) * 0.5f;
+		treeNode.extents[1] = (max.y - min.y) * 0.5f;
+		treeNode.extents[2] = (max.z - min.z) * 0.5f;
+
+		std::fill(treeNode.childs, treeNode.childs + 8, INVALID_INDEX);
+
+		treeNode.parent = parent;
+		treeNode.depth = parent == INVALID_INDEX ? 0 : m_TreeNodes[parent].depth + 1;
+		treeNode.objectStart = treeNode.objectCount = treeNode.totalCount = 0;
+
+		Vector4 looseExtents(treeNode.extents[0] * m_Looseness,
+			treeNode.extents[1] * m_Looseness, treeNode.extents[2] * m_Looseness, 0.0f);
+		Vector4 center(treeNode.center[0], treeNode.center[1], treeNode.center[2]);
+
+		m_TreeNodes.push_back(treeNode);
+		m_TreeNodeBounds.push_back(BoxBounds(center - looseExtents, center + looseExtents));
+
+		return m_TreeNodes.size() - 1;
+	}
+
+	unsigned int LooseOcTree::GetFitTreeNode(const BoxBounds &aabb)
+	{
+		if (aabb.GetInfinite())
+			return 0;
+
+		Vector4 center = aabb.GetCenter();
+		Vector4 extents = aabb.GetExtents();
+
+		float objCenter[3] = { center.x, center.y, center.z };
+		float objExtents[3] = { extents.x, extents.y, extents.z };
+
+		// objects lie outside the root stay at the root.
+		const TreeNode &root = m_TreeNodes[0];
+		for (int i = 0; i < 3; i++)
+		{
+			if (std::abs(objCenter[i] - root.center[i]) > root.extents[i])
+				return 0;
+		}
+
+		// child's loose bounds contains the object when it's center is inside child's tight bounds,
+		// and it's extents <= (looseness - 1) * child's extents.
+		float ratio = (m_Looseness - 1.0f) * 0.5f;
+
+		unsigned int current = 0;
+		while (m_TreeNodes[current].depth < m_MaxDepth)
+		{
+			TreeNode treeNode = m_TreeNodes[current];
+
+			bool fit = true;
+			for (int i = 0; i < 3; i++)
+			{
+				if (objExtents[i] > treeNode.extents[i] * ratio)
+				{
+					fit = false;
+					break;
+				}
+			}
+
+			if (!fit)
+				break;
+
+			unsigned int childIndex = 0;
+			for (int i = 0; i < 3; i++)
+			{
+				if (objCenter[i] >= treeNode.center[i])
+					childIndex |= 1 << i;
+			}
+
+			unsigned int child = treeNode.childs[childIndex];
+			if (child == INVALID_INDEX)
+			{
+				Vector4 min, max;
+				float *childMin[3] = { &min.x, &min.y, &min.z };
+				float *childMax[3] = { &max.x, &max.y, &max.z };
+
+				for (int i = 0; i < 3; i++)
+				{
+					if (childIndex & (1 << i))
+					{
+						*childMin[i] = treeNode.center[i];
+						*childMax[i] = treeNode.center[i] + treeNode.extents[i];
+					}
+					else
+					{
+						*childMin[i] = treeNode.center[i] - treeNode.extents[i];
+						*childMax[i] = treeNode.center[i];
+					}
+				}
+
+				// CreateTreeNode may reallocate m_TreeNodes, don't keep references across it.
+				child = CreateTreeNode(current, min, max);
+				m_TreeNodes[current].childs[childIndex] = child;
+			}
+
+			current = child;
+		}
+
+		return current;
+	}
+
+	void LooseOcTree::AddToTreeNode(unsigned int entryIndex, unsigned int treeNode)
+	{
+		m_Entries[entryIndex].treeNode = treeNode;
+		m_TreeNodes[treeNode].objectCount++;
+
+		for (unsigned int i = treeNode; i != INVALID_INDEX; i = m_TreeNodes[i].parent)
+			m_TreeNodes[i].totalCount++;
+
+		m_PackDirty = true;
+	}
+
+	void LooseOcTree::RemoveFromTreeNode(unsigned int entryIndex)
+	{
+		unsigned int treeNode = m_Entries[entryIndex].treeNode;
+		if (treeNode == INVALID_INDEX)
+			return;
+
+		m_Entries[entryIndex].treeNode = INVALID_INDEX;
+		m_TreeNodes[treeNode].objectCount--;
+
+		for (unsigned int i = treeNode; i != INVALID_INDEX; i = m_TreeNodes[i].parent)
+			m_TreeNodes[i].totalCount--;
+
+		m_PackDirty = true;
+	}
+
+	void LooseOcTree::PackEntries()
+	{
+		// counting sort entries by tree node, so each node's objects are contiguous.
+		unsigned int offset = 0;
+		for (auto &treeNode : m_TreeNodes)
+		{
+			treeNode.objectStart = offset;
+			offset += treeNode.objectCount;
+		}
+
+		std::vector<unsigned int> cursors(m_TreeNodes.size());
+		for (unsigned int i = 0; i < m_TreeNodes.size(); i++)
+			cursors[i] = m_TreeNodes[i].objectStart;
+
+		m_PackedEntries.resize(m_Entries.size());
+		m_PackedBounds.Resize(m_Entries.size());
+
+		for (unsigned int i = 0; i < m_Entries.size(); i++)
+		{
+			Entry &entry = m_Entries[i];
+			unsigned int packedIndex = cursors[entry.treeNode]++;
+
+			entry.packedIndex = packedIndex;
+			m_PackedEntries[packedIndex] = i;
+			m_PackedBounds.Set(packedIndex, entry.sceneNode->GetWorldAABB());
+		}
+
+		m_PackDirty = false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#ifndef _FURY_LOOSE_OCTREE_H_
+#define _FURY_LOOSE_OCTREE_H_
+
+#include <vector>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+
+#include "Fury/BoxBounds.h"
+#include "Fury/BoxBoundsArray.h"
+#include "Fury/SceneManager.h"
+#include "Fury/Vector4.h"
+
+namespace fury
+{
+	/**
+	 *	Loose octree stored in one contiguous node pool.
+	 *
+	 *	Tree nodes are addressed by 32 bit indices instead of shared_ptrs,
+	 *	each node's bounds is enlarged by 'looseness', so an object is placed by it's size and center only,
+	 *	and never gets stuck in upper levels because it straddles a split plane.
+	 *
+	 *	Objects of a tree node are kept as a range in a flat array,
+	 *	the flat array is repacked by Flush after insert/remove/cell changes.
+	 */
+	class FURY_API LooseOcTree : public SceneManager, public std::enable_shared_from_this<LooseOcTree>
+	{
+	public:
+
+		typedef std::shared_ptr<LooseOcTree> Ptr;
+
+		static Ptr Create(Vector4 min, Vector4 max, unsigned int maxDepth = 6, float looseness = 2.0f);
+
+		static const unsigned int INVALID_INDEX;
+
+	protected:
+
+		struct TreeNode
+		{
+			float center[3];
+
+			float extents[3];
+
+			unsigned int childs[8];
+
+			unsigned int parent;
+
+			unsigned int depth;
+
+			// objects belongs to this node, range in m_PackedEntries.
+			unsigned int objectStart;
+
+			unsigned int objectCount;
+
+			// objects in this node and all it's childs.
+			unsigned int totalCount;
+		};
+
+		struct Entry
+		{
+			std::shared_ptr<SceneNode> sceneNode;
+
+			unsigned int treeNode;
+
+			// index in m_PackedEntries, valid when m_PackDirty is false.
+			unsigned int packedIndex;
+		};
+
+		std::type_index m_TypeIndex;
+
+		unsigned int m_MaxDepth;
+
+		float m_Looseness;
+
+		std::vector<TreeNode> m_TreeNodes;
+
+		// loose bounds of tree nodes, same index as m_TreeNodes.
+		std::vector<BoxBounds> m_TreeNodeBounds;
+
+		std::vector<Entry> m_Entries;
+
+		std::unordered_map<SceneNode*, unsigned int> m_EntryMap;
+
+		std::vector<unsigned int> m_PackedEntries;
+
+		BoxBoundsArray m_PackedBounds;
+
+		bool m_PackDirty = false;
+
+	public:
+
+		LooseOcTree(Vector4 min, Vector4 max, unsigned int maxDepth, float looseness);
+
+		virtual ~LooseOcTree();
+
+		virtual std::type_index GetTypeIndex() const;
+
+		virtual void AddSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
+
+		virtual void RemoveSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
+
+		virtual void UpdateSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
+
+		virtual void Flush();
+
+		virtual void WalkScene(const Collidable &collider, const FilterFunc &filterFunc) const;
+
+		void Reset(Vector4 min, Vector4 max, unsigned int maxDepth);
+
+		virtual void Clear();
+
+		unsigned int GetTreeNodeCount() const;
+
+		unsigned int GetSceneNodeCount() const;
+
+	protected:
+
+		unsigned int CreateTreeNode(unsigned int parent, Vector4 min, Vector4 max);
+
+		// find or create the tree node that fits aabb best.
+		unsigned int GetFitTreeNode(const BoxBounds &aabb);
+
+		void AddToTreeNode(unsigned int entryIndex, unsigned int treeNode);
+
+		void RemoveFromTreeNode(unsigned int entryIndex);
+
+		void PackEntries();
+	};
+}
+
+#endif // _FURY_LOOSE_OCTREE_H_
\ No newline at end of file
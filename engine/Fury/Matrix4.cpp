@@ -277,6 +277,36 @@ namespace fury
 		return output;
 	}
 
+	Matrix4 Matrix4::InverseRigid() const
+	{
+		Matrix4 output;
+
+		// columns of a rotation times uniform scale s are orthogonal, each of length s.
+		float scale2 = Raw[0] * Raw[0] + Raw[1] * Raw[1] + Raw[2] * Raw[2];
+		if (scale2 != 0)
+		{
+			float invScale2 = 1.0f / scale2;
+			output.Raw[0] = Raw[0] * invScale2;
+			output.Raw[1] = Raw[4] * invScale2;
+			output.Raw[2] = Raw[8] * invScale2;
+			output.Raw[3] = 0.0f;
+			output.Raw[4] = Raw[1] * invScale2;
+			output.Raw[5] = Raw[5] * invScale2;
+			output.Raw[6] = Raw[9] * invScale2;
+			output.Raw[7] = 0.0f;
+			output.Raw[8] = Raw[2] * invScale2;
+			output.Raw[9] = Raw[6] * invScale2;
+			output.Raw[10] = Raw[10] * invScale2;
+			output.Raw[11] = 0.0f;
+			output.Raw[12] = -(Raw[12] * output.Raw[0] + Raw[13] * output.Raw[4] + Raw[14] * output.Raw[8]);
+			output.Raw[13] = -(Raw[12] * output.Raw[1] + Raw[13] * output.Raw[5] + Raw[14] * output.Raw[9]);
+			output.Raw[14] = -(Raw[12] * output.Raw[2] + Raw[13] * output.Raw[6] + Raw[14] * output.Raw[10]);
+			output.Raw[15] = 1.0f;
+		}
+
+		return output;
+	}
+
 	Matrix4 Matrix4::Clone() const
 	{
 		return Matrix4(this->Raw);
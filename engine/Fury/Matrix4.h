@@ -84,6 +84,9 @@ namespace fury
 		// No projection term
 		Matrix4 Inverse() const;
 
+		// Rotation, translation and uniform scale only, inverts the 3x3 part by transposing.
+		Matrix4 InverseRigid() const;
+
 		Matrix4 Clone() const;
 
 		bool operator == (const Matrix4 &other) const;
@@ -5,6 +5,7 @@
 #include "Fury/Mesh.h"
 #include "Fury/SceneNode.h"
 #include "Fury/Joint.h"
+#include "Fury/TriangleBVH.h"
 
 namespace fury
 {
@@ -88,6 +89,7 @@ namespace fury
 		Weights("bone_weights", GL_ARRAY_BUFFER, GL_STATIC_DRAW)
 	{
 		m_TypeIndex = typeid(Mesh);
+		OnCastShadowsChange = Signal<>::Create();
 	};
 
 	Mesh::~Mesh()
@@ -261,6 +263,11 @@ namespace fury
 		IDs.UpdateBuffer();
 		Indices.UpdateBuffer();
 
+		{
+			std::lock_guard<std::mutex> lock(m_TriangleBVHMutex);
+			m_TriangleBVH = nullptr;
+		}
+
 		m_Dirty = Indices.GetDirty() || Positions.GetDirty();
 
 		if (m_VAO != 0)
@@ -370,6 +377,39 @@ namespace fury
 
 	void Mesh::SetCastShadows(bool state)
 	{
+		if (m_CastShadows == state)
+			return;
+
 		m_CastShadows = state;
+		OnCastShadowsChange->Emit();
+	}
+
+	std::shared_ptr<TriangleBVH> Mesh::GetTriangleBVH() const
+	{
+		std::lock_guard<std::mutex> lock(m_TriangleBVHMutex);
+
+		if (m_TriangleBVH != nullptr || Positions.Data.empty())
+			return m_TriangleBVH;
+
+		if (m_SubMeshes.empty())
+		{
+			m_TriangleBVH = TriangleBVH::Create(Positions.Data, Indices.Data);
+		}
+		else
+		{
+			std::vector<unsigned int> indices;
+			for (auto &subMesh : m_SubMeshes)
+				indices.insert(indices.end(), subMesh->Indices.Data.begin(), subMesh->Indices.Data.end());
+
+			m_TriangleBVH = TriangleBVH::Create(Positions.Data, indices);
+		}
+
+		return m_TriangleBVH;
+	}
+
+	bool Mesh::RayCast(const Ray &ray, float &distance, unsigned int &triangle) const
+	{
+		auto triangleBVH = GetTriangleBVH();
+		return triangleBVH != nullptr && triangleBVH->RayCast(ray, distance, triangle);
 	}
 }
\ No newline at end of file
@@ -3,11 +3,13 @@
 
 #include <vector>
 #include <unordered_map>
+#include <mutex>
 
 #include "Fury/Entity.h"
 #include "Fury/ArrayBuffers.h"
 #include "Fury/BoxBounds.h"
 #include "Fury/Buffer.h"
+#include "Fury/Signal.h"
 
 namespace fury
 {
@@ -48,6 +50,10 @@ namespace fury
 
 	class Joint;
 
+	class Ray;
+
+	class TriangleBVH;
+
 	class FURY_API Mesh : public Entity, public Buffer
 	{
 	public:
@@ -76,6 +82,11 @@ namespace fury
 
 		bool m_CastShadows = false;
 
+		// built on first ray cast, ray casts may come from ThreadUtil's workers.
+		mutable std::shared_ptr<TriangleBVH> m_TriangleBVH;
+
+		mutable std::mutex m_TriangleBVHMutex;
+
 	public:
 
 		ArrayBufferf Positions;
@@ -92,6 +103,9 @@ namespace fury
 
 		ArrayBufferui Indices;
 
+		// MeshRenders forward this to their scenenodes, so octrees recount shadow casters.
+		Signal<>::Ptr OnCastShadowsChange;
+
 		Mesh(const std::string &name);
 
 		virtual ~Mesh();
@@ -130,6 +144,13 @@ namespace fury
 		bool GetCastShadows() const;
 
 		void SetCastShadows(bool state);
+
+		// built from Positions and Indices (or submeshes' Indices) on first call, UpdateBuffer drops it.
+		// returns nullptr if raw data is deleted. skinned meshes use their bind pose.
+		std::shared_ptr<TriangleBVH> GetTriangleBVH() const;
+
+		// ray is in mesh space, triangle counts through submeshes in order.
+		bool RayCast(const Ray &ray, float &distance, unsigned int &triangle) const;
 	};
 }
 
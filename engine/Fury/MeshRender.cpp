@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <limits>
+
 #include "Fury/EntityManager.h"
 #include "Fury/Log.h"
 #include "Fury/Mesh.h"
@@ -9,6 +12,8 @@
 
 namespace fury
 {
+	const float MeshRender::LOD_HYSTERESIS = 0.1f;
+
 	MeshRender::Ptr MeshRender::Create(const std::shared_ptr<Material> &material, const std::shared_ptr<Mesh> &mesh)
 	{
 		return std::make_shared<MeshRender>(material, mesh);
@@ -88,6 +93,34 @@ namespace fury
 			return false;
 		}
 
+		m_Occluder = false;
+		LoadMemberValue(wrapper, "occluder", m_Occluder);
+
+		// load lods
+		RemoveAllLODs();
+		if (IsArray(wrapper, "lods") && !LoadArray(wrapper, "lods", [&](const void* node) -> bool
+		{
+			float screenSize = 0.0f;
+			if (!LoadMemberValue(node, "mesh", str) || !LoadMemberValue(node, "screen_size", screenSize))
+			{
+				FURYE << "lod needs mesh and screen_size!";
+				return false;
+			}
+			if (auto mesh = Scene::Manager()->Get<Mesh>(str))
+			{
+				AddLOD(mesh, screenSize);
+				return true;
+			}
+			else
+			{
+				FURYE << "Mesh " << str << " not found!";
+				return false;
+			}
+		}))
+		{
+			return false;
+		}
+
 		return true;
 	}
 
@@ -123,6 +156,33 @@ namespace fury
 		}
 		EndArray(wrapper);
 
+		SaveKey(wrapper, "occluder");
+		SaveValue(wrapper, m_Occluder);
+
+		// save lods
+		if (m_LODs.size() > 0)
+		{
+			SaveKey(wrapper, "lods");
+			StartArray(wrapper);
+			for (auto &lod : m_LODs)
+			{
+				if (auto ptr = lod.mesh.lock())
+				{
+					StartObject(wrapper);
+					SaveKey(wrapper, "mesh");
+					SaveValue(wrapper, ptr->GetName());
+					SaveKey(wrapper, "screen_size");
+					SaveValue(wrapper, lod.screenSize);
+					EndObject(wrapper);
+				}
+				else
+				{
+					FURYW << "Found empty lod mesh pointer!";
+				}
+			}
+			EndArray(wrapper);
+		}
+
 		if (object)
 			EndObject(wrapper);
 	}
@@ -137,6 +197,11 @@ namespace fury
 			auto material = m_Materials[i];
 			clone->SetMaterial(material.lock(), i);
 		}
+
+		clone->SetOccluder(m_Occluder);
+
+		for (auto &lod : m_LODs)
+			clone->AddLOD(lod.mesh.lock(), lod.screenSize);
 		
 		return clone;
 	}
@@ -165,9 +230,22 @@ namespace fury
 	void MeshRender::SetMesh(const std::shared_ptr<Mesh> &mesh)
 	{
 		m_Mesh = mesh;
+		DisconnectMesh();
+
+		if (auto owner = m_Owner.lock())
+		{
+			OnAttaching(owner);
+			owner->UpdateCategories();
+		}
+
+		for (auto node : m_SharingNodes)
+		{
+			if (mesh != nullptr)
+				node->SetModelAABB(mesh->GetAABB());
 
-		if (!m_Owner.expired())
-			OnAttaching(m_Owner.lock());
+			ConnectMesh(node->shared_from_this());
+			node->UpdateCategories();
+		}
 	}
 
 	std::shared_ptr<Mesh> MeshRender::GetMesh() const
@@ -175,6 +253,72 @@ namespace fury
 		return m_Mesh.lock();
 	}
 
+	void MeshRender::AddLOD(const std::shared_ptr<Mesh> &mesh, float screenSize)
+	{
+		MeshLOD lod;
+		lod.mesh = mesh;
+		lod.screenSize = screenSize;
+
+		auto it = std::upper_bound(m_LODs.begin(), m_LODs.end(), screenSize, 
+			[](float value, const MeshLOD &other) { return value > other.screenSize; });
+		m_LODs.insert(it, lod);
+	}
+
+	void MeshRender::RemoveAllLODs()
+	{
+		m_LODs.clear();
+	}
+
+	unsigned int MeshRender::GetLODCount() const
+	{
+		return m_LODs.size() + 1;
+	}
+
+	std::shared_ptr<Mesh> MeshRender::GetLODMesh(unsigned int lod) const
+	{
+		if (lod == 0)
+			return m_Mesh.lock();
+		else if (lod <= m_LODs.size())
+			return m_LODs[lod - 1].mesh.lock();
+		else
+			return nullptr;
+	}
+
+	float MeshRender::GetLODScreenSize(unsigned int lod) const
+	{
+		if (lod > 0 && lod <= m_LODs.size())
+			return m_LODs[lod - 1].screenSize;
+		else
+			return std::numeric_limits<float>::max();
+	}
+
+	unsigned int MeshRender::GetLOD(unsigned int currentLOD, float screenSize, int bias) const
+	{
+		if (m_LODs.empty())
+			return 0;
+
+		unsigned int lodCount = GetLODCount();
+		unsigned int lod = std::min(currentLOD, lodCount - 1);
+
+		while (lod + 1 < lodCount && screenSize < m_LODs[lod].screenSize * (1.0f - LOD_HYSTERESIS))
+			lod++;
+
+		while (lod > 0 && screenSize > m_LODs[lod - 1].screenSize * (1.0f + LOD_HYSTERESIS))
+			lod--;
+
+		lod = std::min((unsigned int)std::max((int)lod + bias, 0), lodCount - 1);
+
+		// expired meshes or meshes with more submeshes than materials fall back to finer lods.
+		for (; lod > 0; lod--)
+		{
+			auto mesh = m_LODs[lod - 1].mesh.lock();
+			if (mesh != nullptr && mesh->GetSubMeshCount() <= m_Materials.size())
+				break;
+		}
+
+		return lod;
+	}
+
 	bool MeshRender::GetRenderable() const
 	{
 		if (m_Mesh.expired())
@@ -193,18 +337,88 @@ namespace fury
 		return true;
 	}
 
+	bool MeshRender::GetOccluder() const
+	{
+		return m_Occluder;
+	}
+
+	void MeshRender::SetOccluder(bool occluder)
+	{
+		m_Occluder = occluder;
+	}
+
 	void MeshRender::OnAttaching(const std::shared_ptr<SceneNode> &node)
 	{
 		Component::OnAttaching(node);
+		DisconnectMesh(node.get());
+
 		if (m_Mesh.expired())
 			return;
 
 		node->SetModelAABB(m_Mesh.lock()->GetAABB());
+		ConnectMesh(node);
 	}
 
 	void MeshRender::OnDetaching(const std::shared_ptr<SceneNode> &node)
 	{
 		Component::OnDetaching(node);
+		DisconnectMesh(node.get());
 		node->SetModelAABB(BoxBounds());
 	}
+
+	void MeshRender::OnOwnerDestructing(SceneNode &node)
+	{
+		Component::OnOwnerDestructing(node);
+		DisconnectMesh(&node);
+	}
+
+	void MeshRender::OnSharing(const std::shared_ptr<SceneNode> &node)
+	{
+		m_SharingNodes.push_back(node.get());
+		ConnectMesh(node);
+	}
+
+	void MeshRender::OnUnsharing(SceneNode &node)
+	{
+		// instances are mostly destroyed in reverse order.
+		auto it = std::find(m_SharingNodes.rbegin(), m_SharingNodes.rend(), &node);
+		if (it != m_SharingNodes.rend())
+		{
+			*it = m_SharingNodes.back();
+			m_SharingNodes.pop_back();
+		}
+
+		DisconnectMesh(&node);
+	}
+
+	void MeshRender::ConnectMesh(const std::shared_ptr<SceneNode> &node)
+	{
+		auto mesh = m_Mesh.lock();
+		if (mesh == nullptr)
+			return;
+
+		// all connections are to the current mesh, SetMesh moves them together.
+		m_SignalMesh = mesh;
+		m_MeshConnections.push_back({ node.get(), mesh->OnCastShadowsChange->Connect(node, &SceneNode::UpdateCategories) });
+	}
+
+	void MeshRender::DisconnectMesh(SceneNode *node)
+	{
+		auto mesh = m_SignalMesh.lock();
+
+		for (size_t i = m_MeshConnections.size(); i-- > 0;)
+		{
+			if (node != nullptr && m_MeshConnections[i].node != node)
+				continue;
+
+			if (mesh != nullptr)
+				mesh->OnCastShadowsChange->Disconnect(m_MeshConnections[i].key);
+
+			m_MeshConnections[i] = m_MeshConnections.back();
+			m_MeshConnections.pop_back();
+		}
+
+		if (m_MeshConnections.empty())
+			m_SignalMesh.reset();
+	}
 }
\ No newline at end of file
@@ -17,12 +17,43 @@ namespace fury
 
 		static Ptr Create(const std::shared_ptr<Material> &material, const std::shared_ptr<Mesh> &mesh);
 
+		// a lod switch has to pass it's threshold by this fraction, so lods don't pop back and forth.
+		static const float LOD_HYSTERESIS;
+
 	protected:
 
+		struct MeshLOD
+		{
+			std::weak_ptr<Mesh> mesh;
+
+			float screenSize;
+		};
+
 		std::vector<std::weak_ptr<Material>> m_Materials;
 
+		// lod 0.
 		std::weak_ptr<Mesh> m_Mesh;
 
+		// coarser lods after m_Mesh, sorted by screenSize from large to small.
+		std::vector<MeshLOD> m_LODs;
+
+		bool m_Occluder = false;
+
+		struct MeshConnection
+		{
+			SceneNode *node;
+
+			size_t key;
+		};
+
+		// connections to mesh's OnCastShadowsChange, for the owner and each scenenode sharing this.
+		std::weak_ptr<Mesh> m_SignalMesh;
+
+		std::vector<MeshConnection> m_MeshConnections;
+
+		// prefab instances sharing this, they unshare before they're destroyed.
+		std::vector<SceneNode*> m_SharingNodes;
+
 	public:
 
 		MeshRender(const std::shared_ptr<Material> &material, const std::shared_ptr<Mesh> &mesh);
@@ -33,6 +64,11 @@ namespace fury
 
 		Component::Ptr Clone() const override;
 
+		bool GetShareable() const override
+		{
+			return true;
+		}
+
 		void UpdateBuffer();
 
 		// if index exceeds material.size().
@@ -47,13 +83,48 @@ namespace fury
 
 		std::shared_ptr<Mesh> GetMesh() const;
 
+		// mesh is used when the node's screen size drops below screenSize.
+		// screen size is the projected diameter as a fraction of viewport height, see Camera::GetScreenSize.
+		void AddLOD(const std::shared_ptr<Mesh> &mesh, float screenSize);
+
+		void RemoveAllLODs();
+
+		// including lod 0, which is GetMesh().
+		unsigned int GetLODCount() const;
+
+		std::shared_ptr<Mesh> GetLODMesh(unsigned int lod) const;
+
+		// screen size below which lod is used, lod 0 has no threshold.
+		float GetLODScreenSize(unsigned int lod) const;
+
+		// lod for screenSize, stepping from currentLOD with hysteresis.
+		// this is shared by prefab instances, so the scenenode keeps currentLOD, see SceneNode::GetCurrentLOD.
+		// bias moves to coarser lods, lods that can't be drawn with current materials are skipped.
+		unsigned int GetLOD(unsigned int currentLOD, float screenSize, int bias = 0) const;
+
 		bool GetRenderable() const;
 
+		// occluders are rasterized by OcclusionCuller to hide objects behind them.
+		bool GetOccluder() const;
+
+		void SetOccluder(bool occluder);
+
 	protected:
 
 		virtual void OnAttaching(const std::shared_ptr<SceneNode> &node) override;
 
 		virtual void OnDetaching(const std::shared_ptr<SceneNode> &node) override;
+
+		virtual void OnOwnerDestructing(SceneNode &node) override;
+
+		virtual void OnSharing(const std::shared_ptr<SceneNode> &node) override;
+
+		virtual void OnUnsharing(SceneNode &node) override;
+
+		void ConnectMesh(const std::shared_ptr<SceneNode> &node);
+
+		// all connections if node is null.
+		void DisconnectMesh(SceneNode *node = nullptr);
 	};
 }
 
@@ -1,4 +1,6 @@
-#include <deque>
+#include <algorithm>
+#include <queue>
+#include <tuple>
 
 #include "Fury/Frustum.h"
 #include "Fury/Light.h"
@@ -7,13 +9,21 @@
 #include "Fury/MeshRender.h"
 #include "Fury/OcTreeNode.h"
 #include "Fury/OcTree.h"
+#include "Fury/Ray.h"
 #include "Fury/RenderQuery.h"
 #include "Fury/SceneNode.h"
 #include "Fury/SphereBounds.h"
+#include "Fury/ThreadUtil.h"
 #include "Fury/Log.h"
 
 namespace fury
 {
+	// smaller ray batches are cast on calling thread.
+	static const unsigned int PARALLEL_RAY_BATCH = 64;
+
+	static const unsigned int RENDER_QUERY_CATEGORIES = 
+		(unsigned int)SceneNodeCategory::RENDERABLE | (unsigned int)SceneNodeCategory::LIGHT;
+
 	OcTree::Ptr OcTree::Create(Vector4 min, Vector4 max, unsigned int maxDepth)
 	{
 		return std::make_shared<OcTree>(min, max, maxDepth);
@@ -23,11 +33,13 @@ namespace fury
 		m_TypeIndex(typeid(OcTree)), m_MaxDepth(maxDepth)
 	{
 		m_Root = OcTreeNode::Create(*this, nullptr, min, max);
+		m_StaticRoot = OcTreeNode::Create(*this, nullptr, min, max);
 	}
 
 	OcTree::~OcTree()
 	{
 		m_Root.reset();
+		m_StaticRoot.reset();
 		FURYD << "OcTree::~OcTree";
 	}
 
@@ -38,15 +50,97 @@ namespace fury
 
 	void OcTree::AddSceneNode(const SceneNode::Ptr &sceneNode)
 	{
-		AddSceneNode(sceneNode, m_Root, 0);
+		FindFitNode(sceneNode->GetWorldAABB(), sceneNode->GetStatic() ? m_StaticRoot : m_Root, 0)->AddSceneNode(sceneNode);
+		RecordChange(sceneNode.get(), false);
+	}
+
+	void OcTree::AddSceneNodeRecursively(const SceneNode::Ptr &sceneNode)
+	{
+		SceneNodes sceneNodes;
+
+		std::vector<SceneNode::Ptr> possibleNodes;
+		possibleNodes.push_back(sceneNode);
+
+		while (!possibleNodes.empty())
+		{
+			SceneNode::Ptr currentNode = possibleNodes.back();
+			possibleNodes.pop_back();
+
+			sceneNodes.push_back(currentNode);
+
+			for (unsigned int i = 0; i < currentNode->GetChildCount(); i++)
+				possibleNodes.push_back(currentNode->GetChildAt(i));
+		}
+
+		Build(sceneNodes);
+	}
+
+	void OcTree::Build(const SceneNodes &sceneNodes, bool parallel)
+	{
+		std::vector<BuildItem> items;
+		items.reserve(sceneNodes.size());
+
+		for (auto &sceneNode : sceneNodes)
+		{
+			// scenenodes already in this tree are moved.
+			sceneNode->RemoveFromOcTree(false);
+			RecordChange(sceneNode.get(), false);
+
+			BuildItem item;
+			item.sceneNode = sceneNode;
+			item.aabb = sceneNode->GetWorldAABB();
+			item.categories = sceneNode->GetCategories();
+			items.push_back(item);
+		}
+
+		if (items.empty())
+			return;
+
+		auto &threadUtil = ThreadUtil::Instance();
+		parallel = parallel && items.size() >= m_ParallelBuildThreshold && 
+			threadUtil->GetWorkerCount() > 0 && threadUtil->IsMainThread();
+
+		std::vector<unsigned int> order, staticOrder;
+		for (unsigned int i = 0; i < items.size(); i++)
+		{
+			if (items[i].sceneNode->GetStatic())
+				staticOrder.push_back(i);
+			else
+				order.push_back(i);
+		}
+
+		if (!order.empty())
+			m_Root->m_TotalSceneNodeCount += BuildTreeNode(m_Root, 0, items, order, 0, order.size(), parallel);
+
+		if (!staticOrder.empty())
+			m_StaticRoot->m_TotalSceneNodeCount += BuildTreeNode(m_StaticRoot, 0, items, staticOrder, 0, staticOrder.size(), parallel);
+
+		// category counts run up to root, add them after workers are done.
+		for (auto &item : items)
+			item.sceneNode->GetOcTreeNode()->IncreaseCategoryCount(item.categories);
 	}
 
-	void OcTree::AddSceneNodeRecursively(const std::shared_ptr<SceneNode> &sceneNode)
+	void OcTree::BuildStatic()
 	{
-		AddSceneNode(sceneNode);
+		SceneNodes sceneNodes;
+		sceneNodes.reserve(m_StaticRoot->GetTotalSceneNodeCount());
+
+		BoxBounds everything;
+		everything.SetInfinite(true);
+
+		auto collect = [&](const SceneNode::Ptr &sceneNode)
+		{
+			sceneNodes.push_back(sceneNode);
+		};
+		VisitTreeNode(*m_StaticRoot, true, everything, collect, 0);
 
-		for (unsigned int i = 0; i < sceneNode->GetChildCount(); i++)
-			AddSceneNodeRecursively(sceneNode->GetChildAt(i));
+		m_StaticRoot->Clear();
+		Build(sceneNodes);
+	}
+
+	unsigned int OcTree::GetStaticSceneNodeCount() const
+	{
+		return m_StaticRoot->GetTotalSceneNodeCount();
 	}
 
 	void OcTree::RemoveSceneNode(const SceneNode::Ptr &sceneNode)
@@ -56,8 +150,75 @@ namespace fury
 
 	void OcTree::UpdateSceneNode(const SceneNode::Ptr &sceneNode)
 	{
-		sceneNode->RemoveFromOcTree(false);
-		AddSceneNode(sceneNode);
+		OcTreeNode::Ptr treeNode = sceneNode->GetOcTreeNode();
+		if (treeNode == nullptr || &treeNode->GetManager() != this)
+		{
+			sceneNode->RemoveFromOcTree(false);
+			AddSceneNode(sceneNode);
+			return;
+		}
+
+		RecordChange(sceneNode.get(), false);
+
+		BoxBounds nodeBounds = sceneNode->GetWorldAABB();
+
+		// climb to the nearest ancestor that still contains the new aabb, 
+		// placing from there gives the same node as placing from root.
+		OcTreeNode::Ptr ancestor = treeNode;
+		while (ancestor->m_Parent != nullptr && !ancestor->Contains(nodeBounds))
+			ancestor = ancestor->m_Parent;
+
+		OcTreeNode::Ptr fitNode = FindFitNode(nodeBounds, ancestor, ancestor->GetDepth());
+		if (fitNode == treeNode)
+		{
+			treeNode->UpdateSceneNodeBounds(sceneNode);
+			return;
+		}
+
+		// counts of ancestor and above don't change, 
+		// unless categories changed with the aabb, as components attach and detach.
+		treeNode->UpdateSceneNodeCategories(sceneNode);
+		treeNode->RemoveSceneNode(sceneNode, ancestor.get());
+		fitNode->AddSceneNode(sceneNode, ancestor.get());
+	}
+
+	void OcTree::UpdateSceneNodes(const SceneNodes &sceneNodes)
+	{
+		SceneNodes movedNodes;
+
+		for (auto &sceneNode : sceneNodes)
+		{
+			OcTreeNode::Ptr treeNode = sceneNode->GetOcTreeNode();
+			if (treeNode == nullptr || &treeNode->GetManager() != this)
+			{
+				movedNodes.push_back(sceneNode);
+				continue;
+			}
+
+			// UpdateSceneNode's test without climbing, a scenenode leaving it's tree node has to move anyway.
+			BoxBounds nodeBounds = sceneNode->GetWorldAABB();
+			if ((treeNode->m_Parent == nullptr || treeNode->Contains(nodeBounds)) && 
+				FindFitNode(nodeBounds, treeNode, treeNode->GetDepth()) == treeNode)
+			{
+				RecordChange(sceneNode.get(), false);
+				treeNode->UpdateSceneNodeBounds(sceneNode);
+			}
+			else
+			{
+				movedNodes.push_back(sceneNode);
+			}
+		}
+
+		// few moves are cheaper from their old tree nodes, many are partitioned from root on workers.
+		if (movedNodes.size() < m_BatchUpdateThreshold)
+		{
+			for (auto &sceneNode : movedNodes)
+				UpdateSceneNode(sceneNode);
+		}
+		else
+		{
+			Build(movedNodes);
+		}
 	}
 
 	void OcTree::GetRenderQuery(const Collidable &collider, const std::shared_ptr<RenderQuery> &renderQuery, bool clear) const
@@ -65,17 +226,40 @@ namespace fury
 		if (clear)
 			renderQuery->Clear();
 
-		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode)
+		if (!CanCullParallel())
 		{
-			if (sceneNode->GetComponent<Light>() != nullptr)
-				renderQuery->AddLight(sceneNode);
-			
-			if (auto render = sceneNode->GetComponent<MeshRender>())
+			Visit(collider, [&](const SceneNode::Ptr &sceneNode)
 			{
-				if (render->GetRenderable())
+				if (sceneNode->GetComponent<Light>() != nullptr)
+					renderQuery->AddLight(sceneNode);
+
+				auto render = sceneNode->GetComponent<MeshRender>();
+				if (render != nullptr && render->GetRenderable())
 					renderQuery->AddRenderable(sceneNode);
-			}
-		});
+			}, RENDER_QUERY_CATEGORIES);
+			return;
+		}
+
+		SceneNodes sceneNodes;
+		WalkSceneParallel(collider, sceneNodes, [](const SceneNode::Ptr &sceneNode)
+		{
+			if (sceneNode->GetComponent<Light>() != nullptr)
+				return true;
+
+			auto render = sceneNode->GetComponent<MeshRender>();
+			return render != nullptr && render->GetRenderable();
+		}, RENDER_QUERY_CATEGORIES);
+
+		// RenderQuery isn't thread safe, fill it on calling thread.
+		for (auto &sceneNode : sceneNodes)
+		{
+			if (sceneNode->GetComponent<Light>() != nullptr)
+				renderQuery->AddLight(sceneNode);
+
+			auto render = sceneNode->GetComponent<MeshRender>();
+			if (render != nullptr && render->GetRenderable())
+				renderQuery->AddRenderable(sceneNode);
+		}
 	}
 
 	void OcTree::GetVisibleSceneNodes(const Collidable &collider, SceneNodes &sceneNodes, bool clear) const
@@ -83,7 +267,7 @@ namespace fury
 		if (clear)
 			sceneNodes.clear();
 
-		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode) 
+		Visit(collider, [&](const SceneNode::Ptr &sceneNode)
 		{
 			sceneNodes.push_back(sceneNode);
 		});
@@ -94,12 +278,25 @@ namespace fury
 		if (clear)
 			renderables.clear();
 
-		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode)
+		auto isRenderable = [](const SceneNode::Ptr &sceneNode)
 		{
 			auto render = sceneNode->GetComponent<MeshRender>();
-			if (render != nullptr && render->GetRenderable())
+			return render != nullptr && render->GetRenderable();
+		};
+
+		const unsigned int categories = (unsigned int)SceneNodeCategory::RENDERABLE;
+
+		if (CanCullParallel())
+		{
+			WalkSceneParallel(collider, renderables, isRenderable, categories);
+			return;
+		}
+
+		Visit(collider, [&](const SceneNode::Ptr &sceneNode)
+		{
+			if (isRenderable(sceneNode))
 				renderables.push_back(sceneNode);
-		});
+		}, categories);
 	}
 
 	void OcTree::GetVisibleShadowCasters(const Collidable &collider, SceneNodes &renderables, bool clear) const
@@ -107,12 +304,25 @@ namespace fury
 		if (clear)
 			renderables.clear();
 
-		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode)
+		auto isShadowCaster = [](const SceneNode::Ptr &sceneNode)
 		{
 			auto render = sceneNode->GetComponent<MeshRender>();
-			if (render != nullptr && render->GetRenderable() && render->GetMesh()->GetCastShadows())
+			return render != nullptr && render->GetRenderable() && render->GetMesh()->GetCastShadows();
+		};
+
+		const unsigned int categories = (unsigned int)SceneNodeCategory::SHADOW_CASTER;
+
+		if (CanCullParallel())
+		{
+			WalkSceneParallel(collider, renderables, isShadowCaster, categories);
+			return;
+		}
+
+		Visit(collider, [&](const SceneNode::Ptr &sceneNode)
+		{
+			if (isShadowCaster(sceneNode))
 				renderables.push_back(sceneNode);
-		});
+		}, categories);
 	}
 
 	void OcTree::GetVisibleLights(const Collidable &collider, SceneNodes &lights, bool clear) const
@@ -120,12 +330,12 @@ namespace fury
 		if (clear)
 			lights.clear();
 
-		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode)
+		// lights are few, a parallel walk won't pay off.
+		Visit(collider, [&](const SceneNode::Ptr &sceneNode)
 		{
 			if (sceneNode->GetComponent<Light>() != nullptr)
 				lights.push_back(sceneNode);
-
-		});
+		}, (unsigned int)SceneNodeCategory::LIGHT);
 	}
 
 	void OcTree::GetVisibleRenderableAndLights(const Collidable &collider, SceneNodes &renderables, SceneNodes &lights, bool clear) const
@@ -136,89 +346,421 @@ namespace fury
 			lights.clear();
 		}
 
-		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode)
+		Visit(collider, [&](const SceneNode::Ptr &sceneNode)
 		{
 			auto render = sceneNode->GetComponent<MeshRender>();
 			if (render != nullptr && render->GetRenderable())
 				renderables.push_back(sceneNode);
 			else if (sceneNode->GetComponent<Light>() != nullptr)
 				lights.push_back(sceneNode);
-
-		});
+		}, RENDER_QUERY_CATEGORIES);
 	}
 
 	void OcTree::WalkScene(const Collidable &collider, const FilterFunc &filterFunc) const
 	{
-		using TreeNodePair = std::pair<bool, OcTreeNode::Ptr>;
+		Visit(collider, filterFunc);
+	}
+
+	void OcTree::WalkSceneViews(const std::vector<const Collidable*> &colliders, const ViewFilterFunc &filterFunc, unsigned int categories) const
+	{
+		VisitViews(colliders, filterFunc, categories);
+	}
+
+	bool OcTree::RayCast(const Ray &ray, RayHit &hit, bool testTriangles, const QueryFilterFunc &filterFunc) const
+	{
+		using TreeNodePair = std::pair<float, OcTreeNode::Ptr>;
+
+		auto fartherFirst = [](const TreeNodePair &a, const TreeNodePair &b) { return a.first > b.first; };
+		std::priority_queue<TreeNodePair, std::vector<TreeNodePair>, decltype(fartherFirst)> possiblePairs(fartherFirst);
 
-		std::deque<TreeNodePair> possiblePairs;
-		possiblePairs.push_back(std::make_pair(false, m_Root));
+		// roots also keep scenenodes outside of their bounds, so they're always visited.
+		possiblePairs.push(std::make_pair(0.0f, m_Root));
+		possiblePairs.push(std::make_pair(0.0f, m_StaticRoot));
+
+		hit = RayHit();
+		float closest = ray.GetMaxDistance();
+
+		RayHit current;
+		std::vector<std::pair<float, unsigned int>> candidates;
 
 		while (!possiblePairs.empty())
 		{
-			// pop next possible node.
-			TreeNodePair currentPair = possiblePairs.back();
-			possiblePairs.pop_back();
+			TreeNodePair currentPair = possiblePairs.top();
+			possiblePairs.pop();
+
+			// scenenodes of a tree node lie inside it, so nothing left can be closer.
+			if (currentPair.first > closest)
+				break;
 
-			// procced
-			bool tested = currentPair.first;
 			OcTreeNode::Ptr treeNode = currentPair.second;
 
-			if (treeNode->GetTotalSceneNodeCount() > 0)
+			// test this node's scenenodes near to far.
+			candidates.clear();
+			const BoxBoundsArray &sceneNodeBounds = treeNode->GetSceneNodeBounds();
+			for (unsigned int i = 0; i < treeNode->GetSceneNodeCount(); i++)
 			{
-				Side result = tested ? Side::IN : collider.IsInside(treeNode->GetAABB());
+				float near, far;
+				if (ray.Intersects(sceneNodeBounds.GetBoxBounds(i), near, far) && near <= closest)
+					candidates.push_back(std::make_pair(near, i));
+			}
 
-				if (result != Side::OUT)
+			std::sort(candidates.begin(), candidates.end());
+
+			for (auto &candidate : candidates)
+			{
+				if (candidate.first > closest)
+					break;
+
+				SceneNode::Ptr sceneNode = treeNode->GetSceneNodeAt(candidate.second);
+				if (filterFunc != nullptr && !filterFunc(sceneNode))
+					continue;
+
+				if (RayCastSceneNode(ray, sceneNode, candidate.first, testTriangles, current) && current.distance <= closest)
 				{
-					if (result == Side::IN)
-						tested = true;
-
-					// test currentTreeNode's belonging sceneNodes
-					int sceneNodeCount = treeNode->GetSceneNodeCount();
-					for (int i = 0; i < sceneNodeCount; i++)
-					{
-						SceneNode::Ptr sceneNode = treeNode->GetSceneNodeAt(i);
-						if (tested || collider.IsInsideFast(sceneNode->GetWorldAABB()))
-							filterFunc(sceneNode);
-					}
-
-					// add currentTreeNode's childs to possiblePairs vector.
-					for (int i = 0; i < 8; i++)
-					{
-						OcTreeNode::Ptr childNode = treeNode->GetChildAt(i);
-						if (childNode != nullptr && childNode->GetTotalSceneNodeCount() > 0)
-							possiblePairs.push_back(std::make_pair(tested, childNode));
-					}
+					closest = current.distance;
+					hit = current;
 				}
 			}
+
+			for (int i = 0; i < 8; i++)
+			{
+				OcTreeNode::Ptr childNode = treeNode->GetChildAt(i);
+				if (childNode == nullptr || childNode->GetTotalSceneNodeCount() == 0)
+					continue;
+
+				float near, far;
+				if (ray.Intersects(childNode->GetAABB(), near, far) && near <= closest)
+					possiblePairs.push(std::make_pair(near, childNode));
+			}
+		}
+
+		return hit.sceneNode != nullptr;
+	}
+
+	void OcTree::QueryNearest(Vector4 point, unsigned int k, SceneNodes &nearest, const QueryFilterFunc &filterFunc, float maxDistance) const
+	{
+		nearest.clear();
+		if (k == 0)
+			return;
+
+		using TreeNodePair = std::pair<float, OcTreeNode::Ptr>;
+
+		auto fartherFirst = [](const TreeNodePair &a, const TreeNodePair &b) { return a.first > b.first; };
+		std::priority_queue<TreeNodePair, std::vector<TreeNodePair>, decltype(fartherFirst)> possiblePairs(fartherFirst);
+
+		// roots also keep scenenodes outside of their bounds, so they're always visited.
+		possiblePairs.push(std::make_pair(0.0f, m_Root));
+		possiblePairs.push(std::make_pair(0.0f, m_StaticRoot));
+
+		std::vector<NearestPair> heap;
+		heap.reserve(k);
+
+		while (!possiblePairs.empty())
+		{
+			TreeNodePair currentPair = possiblePairs.top();
+			possiblePairs.pop();
+
+			// scenenodes of a tree node lie inside it, so nothing left can be nearer.
+			float farthest = heap.size() < k ? maxDistance : heap.front().first;
+			if (currentPair.first > farthest)
+				break;
+
+			OcTreeNode::Ptr treeNode = currentPair.second;
+
+			const BoxBoundsArray &sceneNodeBounds = treeNode->GetSceneNodeBounds();
+			for (unsigned int i = 0; i < treeNode->GetSceneNodeCount(); i++)
+			{
+				float distance = sceneNodeBounds.GetBoxBounds(i).GetDistance(point);
+				if (distance > maxDistance || (heap.size() == k && distance >= heap.front().first))
+					continue;
+
+				SceneNode::Ptr sceneNode = treeNode->GetSceneNodeAt(i);
+				if (filterFunc == nullptr || filterFunc(sceneNode))
+					PushNearest(heap, k, distance, sceneNode);
+			}
+
+			farthest = heap.size() < k ? maxDistance : heap.front().first;
+			for (int i = 0; i < 8; i++)
+			{
+				OcTreeNode::Ptr childNode = treeNode->GetChildAt(i);
+				if (childNode == nullptr || childNode->GetTotalSceneNodeCount() == 0)
+					continue;
+
+				float distance = childNode->GetAABB().GetDistance(point);
+				if (distance <= farthest)
+					possiblePairs.push(std::make_pair(distance, childNode));
+			}
+		}
+
+		PopNearest(heap, nearest);
+	}
+
+	void OcTree::RayCastBatch(const std::vector<Ray> &rays, std::vector<RayHit> &hits, bool testTriangles, const QueryFilterFunc &filterFunc) const
+	{
+		hits.resize(rays.size());
+
+		// tree queries don't modify the tree, each chunk writes it's own range of hits.
+		ThreadUtil::Instance()->ParallelFor(rays.size(), PARALLEL_RAY_BATCH, [&](unsigned int start, unsigned int end)
+		{
+			for (unsigned int i = start; i < end; i++)
+				RayCast(rays[i], hits[i], testTriangles, filterFunc);
+		});
+	}
+
+	void OcTree::SetParallelCulling(bool enable, unsigned int splitDepth, unsigned int threshold)
+	{
+		m_ParallelCulling = enable;
+		m_ParallelDepth = splitDepth;
+		m_ParallelCullingThreshold = threshold;
+	}
+
+	bool OcTree::GetParallelCulling() const
+	{
+		return m_ParallelCulling;
+	}
+
+	void OcTree::SetParallelBuildThreshold(unsigned int threshold)
+	{
+		m_ParallelBuildThreshold = threshold;
+	}
+
+	unsigned int OcTree::GetParallelBuildThreshold() const
+	{
+		return m_ParallelBuildThreshold;
+	}
+
+	void OcTree::SetBatchUpdateThreshold(unsigned int threshold)
+	{
+		m_BatchUpdateThreshold = threshold;
+	}
+
+	unsigned int OcTree::GetBatchUpdateThreshold() const
+	{
+		return m_BatchUpdateThreshold;
+	}
+
+	void OcTree::WalkSceneParallel(const Collidable &collider, SceneNodes &sceneNodes, const CullFunc &cullFunc, unsigned int categories) const
+	{
+		using TreeNodeTask = std::tuple<bool, unsigned int, OcTreeNode::Ptr>;
+		using TreeNodePair = std::pair<bool, OcTreeNode::Ptr>;
+
+		// walk the top levels on calling thread, 
+		// subtrees at m_ParallelDepth are collected as tasks in depth first order.
+		std::vector<TreeNodePair> subTrees;
+		std::vector<TreeNodeTask> possibleTasks;
+		possibleTasks.push_back(std::make_tuple(false, 0, m_StaticRoot));
+		possibleTasks.push_back(std::make_tuple(false, 0, m_Root));
+
+		std::vector<unsigned char> results;
+
+		while (!possibleTasks.empty())
+		{
+			TreeNodeTask currentTask = possibleTasks.back();
+			possibleTasks.pop_back();
+
+			bool tested = std::get<0>(currentTask);
+			unsigned int depth = std::get<1>(currentTask);
+			OcTreeNode::Ptr treeNode = std::get<2>(currentTask);
+
+			if (depth >= m_ParallelDepth)
+			{
+				subTrees.push_back(std::make_pair(tested, treeNode));
+				continue;
+			}
+
+			Side result = tested ? Side::IN : collider.IsInside(treeNode->GetAABB());
+			if (result == Side::OUT)
+				continue;
+
+			if (result == Side::IN)
+				tested = true;
+
+			unsigned int sceneNodeCount = treeNode->GetSceneNodeCount();
+			results.assign(sceneNodeCount, 1);
+			if (!tested && sceneNodeCount > 0)
+				collider.IsInsideFastBatch(treeNode->GetSceneNodeBounds(), 0, sceneNodeCount, results.data());
+
+			for (unsigned int i = 0; i < sceneNodeCount; i++)
+			{
+				if (!results[i] || (categories != 0 && (treeNode->m_SceneNodeCategories[i] & categories) == 0))
+					continue;
+
+				const SceneNode::Ptr &sceneNode = treeNode->m_SceneNodes[i];
+				if (cullFunc(sceneNode))
+					sceneNodes.push_back(sceneNode);
+			}
+
+			for (int i = 7; i >= 0; i--)
+			{
+				OcTreeNode::Ptr childNode = treeNode->GetChildAt(i);
+				if (childNode != nullptr && childNode->HasCategories(categories))
+					possibleTasks.push_back(std::make_tuple(tested, depth + 1, childNode));
+			}
 		}
+
+		if (subTrees.empty())
+			return;
+
+		// each subtree has it's own buffer, so workers never share a container.
+		std::vector<SceneNodes> buffers(subTrees.size());
+		auto cullSubTree = [&](unsigned int index)
+		{
+			SceneNodes &buffer = buffers[index];
+			auto visitor = [&](const SceneNode::Ptr &sceneNode)
+			{
+				if (cullFunc(sceneNode))
+					buffer.push_back(sceneNode);
+			};
+			VisitTreeNode(*subTrees[index].second, subTrees[index].first, collider, visitor, categories);
+		};
+
+		ThreadUtil::Instance()->ParallelFor(subTrees.size(), 1, [&](unsigned int start, unsigned int end)
+		{
+			for (unsigned int i = start; i < end; i++)
+				cullSubTree(i);
+		});
+
+		// merge in subtree order, so the result doesn't depend on task scheduling.
+		size_t totalCount = sceneNodes.size();
+		for (auto &buffer : buffers)
+			totalCount += buffer.size();
+
+		sceneNodes.reserve(totalCount);
+		for (auto &buffer : buffers)
+			sceneNodes.insert(sceneNodes.end(), buffer.begin(), buffer.end());
 	}
 
 	void OcTree::Reset(Vector4 min, Vector4 max, unsigned int maxDepth)
 	{
-		m_Root.reset();
+		// keep attached scenenodes, they are placed again in the new bounds.
+		BoxBounds everything;
+		everything.SetInfinite(true);
+
+		SceneNodes sceneNodes;
+		sceneNodes.reserve(m_Root->GetTotalSceneNodeCount() + m_StaticRoot->GetTotalSceneNodeCount());
+		WalkScene(everything, [&](const SceneNode::Ptr &sceneNode)
+		{
+			sceneNodes.push_back(sceneNode);
+		});
+
+		m_Root->Clear();
+		m_StaticRoot->Clear();
 		m_Root = OcTreeNode::Create(*this, nullptr, min, max);
+		m_StaticRoot = OcTreeNode::Create(*this, nullptr, min, max);
+		m_MaxDepth = maxDepth;
+
+		Build(sceneNodes);
 	}
 
 	void OcTree::Clear()
 	{
 		m_Root->Clear();
+		m_StaticRoot->Clear();
+		RecordReset();
 	}
 
-	void OcTree::AddSceneNode(const SceneNode::Ptr &sceneNode, const OcTreeNode::Ptr &treeNode, unsigned int depth)
+	unsigned int OcTree::BuildTreeNode(const OcTreeNode::Ptr &treeNode, unsigned int depth, 
+		const std::vector<BuildItem> &items, std::vector<unsigned int> &order, unsigned int start, unsigned int end, bool parallel)
 	{
-		BoxBounds treeBounds = treeNode->GetAABB();
-		BoxBounds nodeBounds = sceneNode->GetWorldAABB();
+		// bucket 8 keeps items staying in treeNode, the same rule as FindFitNode.
+		const int stayBucket = 8;
 
-		if ((depth < m_MaxDepth) && treeNode->IsTwiceSize(nodeBounds))
+		std::vector<int> buckets(end - start);
+		unsigned int bucketCounts[9] = { 0 };
+
+		for (unsigned int i = start; i < end; i++)
 		{
-			OcTreeNode::Ptr fitNode = treeNode->GetFitNode(nodeBounds);
-			AddSceneNode(sceneNode, fitNode, ++depth);
+			int bucket = stayBucket;
+			const BoxBounds &aabb = items[order[i]].aabb;
+			if (depth < m_MaxDepth && treeNode->IsTwiceSize(aabb))
+			{
+				int childIndex = treeNode->GetFitChildIndex(aabb);
+				if (childIndex >= 0)
+					bucket = childIndex;
+			}
+
+			buckets[i - start] = bucket;
+			bucketCounts[bucket]++;
 		}
+
+		// counting sort item indices by bucket, so each child gets a contiguous range.
+		unsigned int bucketStarts[10];
+		bucketStarts[0] = start;
+		for (int i = 0; i < 9; i++)
+			bucketStarts[i + 1] = bucketStarts[i] + bucketCounts[i];
+
+		std::vector<unsigned int> sorted(end - start);
+		unsigned int cursors[9];
+		std::copy(bucketStarts, bucketStarts + 9, cursors);
+		for (unsigned int i = start; i < end; i++)
+			sorted[cursors[buckets[i - start]]++ - start] = order[i];
+		std::copy(sorted.begin(), sorted.end(), order.begin() + start);
+
+		// counts of treeNode are added by the caller.
+		for (unsigned int i = bucketStarts[stayBucket]; i < end; i++)
+			treeNode->AddSceneNode(items[order[i]].sceneNode, treeNode.get());
+
+		unsigned int childCounts[8] = { 0 };
+		OcTreeNode::Ptr childs[8];
+
+		auto buildChild = [&](unsigned int index)
+		{
+			childCounts[index] = BuildTreeNode(childs[index], depth + 1, items, order, bucketStarts[index], bucketStarts[index + 1], false);
+			childs[index]->m_TotalSceneNodeCount += childCounts[index];
+		};
+
+		// create childs here, so workers never touch treeNode.
+		for (int i = 0; i < 8; i++)
+		{
+			if (bucketCounts[i] > 0)
+				childs[i] = treeNode->GetOrCreateChild(i);
+		}
+
+		auto buildChilds = [&](unsigned int start, unsigned int end)
+		{
+			for (unsigned int i = start; i < end; i++)
+			{
+				if (bucketCounts[i] > 0)
+					buildChild(i);
+			}
+		};
+
+		if (parallel)
+			ThreadUtil::Instance()->ParallelFor(8, 1, buildChilds);
 		else
+			buildChilds(0, 8);
+
+		unsigned int addedCount = bucketCounts[stayBucket];
+		for (int i = 0; i < 8; i++)
+			addedCount += childCounts[i];
+
+		return addedCount;
+	}
+
+	OcTreeNode::Ptr OcTree::FindFitNode(const BoxBounds &aabb, const OcTreeNode::Ptr &treeNode, unsigned int depth)
+	{
+		OcTreeNode::Ptr currentNode = treeNode;
+
+		while ((depth < m_MaxDepth) && currentNode->IsTwiceSize(aabb))
 		{
-			treeNode->AddSceneNode(sceneNode);
+			OcTreeNode::Ptr fitNode = currentNode->GetFitNode(aabb);
+			if (fitNode == currentNode)
+				break;
+
+			currentNode = fitNode;
+			depth++;
 		}
+
+		return currentNode;
+	}
+
+	bool OcTree::CanCullParallel() const
+	{
+		if (!m_ParallelCulling || m_Root->GetTotalSceneNodeCount() + m_StaticRoot->GetTotalSceneNodeCount() < m_ParallelCullingThreshold)
+			return false;
+
+		auto &threadUtil = ThreadUtil::Instance();
+		return threadUtil->GetWorkerCount() > 0 && threadUtil->IsMainThread();
 	}
 
 }
\ No newline at end of file
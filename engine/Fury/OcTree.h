@@ -1,38 +1,61 @@
 #ifndef _FURY_OCTREE_H_
 #define _FURY_OCTREE_H_
 
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <typeindex>
 
+#include "Fury/BoxBounds.h"
 #include "Fury/Color.h"
+#include "Fury/OcTreeNode.h"
 #include "SceneManager.h"
 #include "Fury/Vector4.h"
 
 namespace fury
 {
-	class OcTreeNode;
-
 	// OcTree holds a shared_ptr to attached scenenodes.
 	// When you need to destory a scenenode.
 	// Call node.RemoveFromOcTree(true) + node.RemoveFromParent() + node.reset().
 	// You'll destory this node and all it's childs.
 	class FURY_API OcTree : public SceneManager, public std::enable_shared_from_this<OcTree>
 	{
+		friend class OcTreeNode;
+
 	public:
 
 		typedef std::shared_ptr<OcTree> Ptr;
 
 		static Ptr Create(Vector4 min, Vector4 max, unsigned int maxDepth = 6);
 
+		// returns true if the sceneNode should be collected, called from worker threads.
+		typedef std::function<bool(const std::shared_ptr<SceneNode>&)> CullFunc;
+
 	protected:
 
 		std::type_index m_TypeIndex;
 
 		std::shared_ptr<OcTreeNode> m_Root;
 
+		// static scenenodes, same bounds as m_Root. 
+		// they never move, so per frame updates and reinsertions stay in m_Root.
+		std::shared_ptr<OcTreeNode> m_StaticRoot;
+
 		unsigned int m_MaxDepth;
 
+		bool m_ParallelCulling = false;
+
+		unsigned int m_ParallelDepth = 2;
+
+		// trees with less scenenodes are always culled on calling thread.
+		unsigned int m_ParallelCullingThreshold = 1024;
+
+		// builds with less scenenodes are partitioned on calling thread.
+		unsigned int m_ParallelBuildThreshold = 1024;
+
+		// UpdateSceneNodes moves less scenenodes one by one, more are reinserted through Build.
+		unsigned int m_BatchUpdateThreshold = 1024;
+
 	public:
 
 		OcTree(Vector4 min, Vector4 max, unsigned int maxDepth);
@@ -43,15 +66,34 @@ namespace fury
 
 		virtual void AddSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
 
+		// adds sceneNode and all it's childs through Build.
 		virtual void AddSceneNodeRecursively(const std::shared_ptr<SceneNode> &sceneNode);
 
+		// bulk insert, partitions all aabbs top-down in one pass instead of adding them one by one.
+		// subtrees of root are built on ThreadUtil's workers when parallel is true and there are enough scenenodes, 
+		// see SetParallelBuildThreshold.
+		// static scenenodes go to the static tree.
+		void Build(const SceneNodes &sceneNodes, bool parallel = true);
+
+		// rebuild the static tree from scratch, dropping tree nodes left empty by removals.
+		// static scenenodes added one by one are placed like dynamic ones, call this after loading or streaming in a batch.
+		void BuildStatic();
+
+		unsigned int GetStaticSceneNodeCount() const;
+
 		virtual void RemoveSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
 
 		virtual void UpdateSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
 
+		// scenenodes still fitting their tree node only refresh bounds, 
+		// the rest are reinserted through Build if there are enough of them, see SetBatchUpdateThreshold.
+		virtual void UpdateSceneNodes(const SceneNodes &sceneNodes);
+
+		// queries below skip subtrees without scenenodes of the category they collect.
+
 		virtual void GetRenderQuery(const Collidable &collider, const std::shared_ptr<RenderQuery> &renderQuery, bool clear = true) const;
 
-		virtual void GetVisibleSceneNodes(const Collidable &collider, SceneNodes &sceneNodes, bool clear = true) const;
+		virtual void GetVisibleSceneNodes(const Collidable &collider, SceneNodes &visibleNodes, bool clear = true) const;
 
 		virtual void GetVisibleRenderables(const Collidable &collider, SceneNodes &renderables, bool clear = true) const;
 
@@ -63,15 +105,209 @@ namespace fury
 
 		virtual void WalkScene(const Collidable &collider, const FilterFunc &filterFunc) const;
 
+		// inlined WalkScene, visitor is called with a const std::shared_ptr<SceneNode>& owned by the tree, 
+		// so visiting neither allocates nor touches reference counts.
+		// categories is a mask of SceneNodeCategory as in WalkSceneParallel.
+		template<class Visitor>
+		void Visit(const Collidable &collider, Visitor &&visitor, unsigned int categories = 0) const;
+
+		// one walk for all colliders, each tree node is tested only against views it straddles.
+		virtual void WalkSceneViews(const std::vector<const Collidable*> &colliders, const ViewFilterFunc &filterFunc, unsigned int categories = 0) const;
+
+		// inlined WalkSceneViews, visitor is called with the tree's const std::shared_ptr<SceneNode>& and a uint32_t view mask.
+		template<class Visitor>
+		void VisitViews(const std::vector<const Collidable*> &colliders, Visitor &&visitor, unsigned int categories = 0) const;
+
+		// visits tree nodes in the order the ray enters them, and stops once the rest start behind the closest hit.
+		virtual bool RayCast(const Ray &ray, RayHit &hit, bool testTriangles = false, const QueryFilterFunc &filterFunc = nullptr) const;
+
+		// visits tree nodes by their distance to point, and stops once the rest are farther than the k-th nearest.
+		virtual void QueryNearest(Vector4 point, unsigned int k, SceneNodes &nearest, const QueryFilterFunc &filterFunc = nullptr, 
+			float maxDistance = std::numeric_limits<float>::max()) const;
+
+		// batches with enough rays are split across ThreadUtil's workers.
+		virtual void RayCastBatch(const std::vector<Ray> &rays, std::vector<RayHit> &hits, bool testTriangles = false, const QueryFilterFunc &filterFunc = nullptr) const;
+
+		// cull subtrees at splitDepth on ThreadUtil's workers, 
+		// GetRenderQuery, GetVisibleRenderables and GetVisibleShadowCasters use this when enabled.
+		// trees with less than threshold scenenodes are still culled on calling thread, 1024 by default.
+		void SetParallelCulling(bool enable, unsigned int splitDepth = 2, unsigned int threshold = 1024);
+
+		bool GetParallelCulling() const;
+
+		// scenenode count from which Build partitions subtrees of root on workers, 1024 by default.
+		void SetParallelBuildThreshold(unsigned int threshold);
+
+		unsigned int GetParallelBuildThreshold() const;
+
+		// moved scenenode count from which UpdateSceneNodes reinserts them through Build, 1024 by default.
+		void SetBatchUpdateThreshold(unsigned int threshold);
+
+		unsigned int GetBatchUpdateThreshold() const;
+
+		// collect visible sceneNodes that pass cullFunc, results are merged in a fixed subtree order.
+		// categories is a mask of SceneNodeCategory, scenenodes in none of them are skipped. 0 visits all.
+		void WalkSceneParallel(const Collidable &collider, SceneNodes &sceneNodes, const CullFunc &cullFunc, unsigned int categories = 0) const;
+
 		virtual void Reset(Vector4 min, Vector4 max, unsigned int maxDepth);
 
 		virtual void Clear();
 
 	protected:
 
-		void AddSceneNode(const std::shared_ptr<SceneNode> &sceneNode, const std::shared_ptr<OcTreeNode> &treeNode, unsigned int depth);
+		struct BuildItem
+		{
+			std::shared_ptr<SceneNode> sceneNode;
+
+			BoxBounds aabb;
+
+			unsigned int categories;
+		};
+
+		// place items[order[start, end)] under treeNode, returns count of added scenenodes.
+		unsigned int BuildTreeNode(const std::shared_ptr<OcTreeNode> &treeNode, unsigned int depth, 
+			const std::vector<BuildItem> &items, std::vector<unsigned int> &order, unsigned int start, unsigned int end, bool parallel);
+
+		// descend from treeNode to the node that aabb should be placed at.
+		std::shared_ptr<OcTreeNode> FindFitNode(const BoxBounds &aabb, const std::shared_ptr<OcTreeNode> &treeNode, unsigned int depth);
+
+		// recursion depth is bounded by max depth, so no traversal stack is allocated.
+		template<class Visitor>
+		void VisitTreeNode(const OcTreeNode &treeNode, bool tested, const Collidable &collider, 
+			Visitor &visitor, unsigned int categories) const;
+
+		// testMask holds views that straddle parent, insideMask views that contain it.
+		template<class Visitor>
+		void VisitViewsTreeNode(const OcTreeNode &treeNode, uint32_t testMask, uint32_t insideMask, 
+			const std::vector<const Collidable*> &colliders, Visitor &visitor, unsigned int categories) const;
+
+		bool CanCullParallel() const;
 
 	};
+
+	template<class Visitor>
+	void OcTree::Visit(const Collidable &collider, Visitor &&visitor, unsigned int categories) const
+	{
+		VisitTreeNode(*m_Root, false, collider, visitor, categories);
+		VisitTreeNode(*m_StaticRoot, false, collider, visitor, categories);
+	}
+
+	template<class Visitor>
+	void OcTree::VisitTreeNode(const OcTreeNode &treeNode, bool tested, const Collidable &collider, 
+		Visitor &visitor, unsigned int categories) const
+	{
+		if (!treeNode.HasCategories(categories))
+			return;
+
+		if (!tested)
+		{
+			Side result = collider.IsInside(treeNode.m_AABB);
+			if (result == Side::OUT)
+				return;
+
+			tested = result == Side::IN;
+		}
+
+		// test scenenodes in fixed size chunks, so results stay on the stack.
+		const unsigned int chunkSize = 64;
+		unsigned char results[chunkSize];
+
+		unsigned int sceneNodeCount = treeNode.m_SceneNodes.size();
+		for (unsigned int start = 0; start < sceneNodeCount; start += chunkSize)
+		{
+			unsigned int count = std::min(chunkSize, sceneNodeCount - start);
+			if (tested)
+				std::fill(results, results + count, 1);
+			else
+				collider.IsInsideFastBatch(treeNode.m_SceneNodeBounds, start, count, results);
+
+			for (unsigned int i = 0; i < count; i++)
+			{
+				if (results[i] && (categories == 0 || (treeNode.m_SceneNodeCategories[start + i] & categories)))
+					visitor(treeNode.m_SceneNodes[start + i]);
+			}
+		}
+
+		for (int i = 0; i < 8; i++)
+		{
+			if (const OcTreeNode *childNode = treeNode.m_Childs[i].get())
+				VisitTreeNode(*childNode, tested, collider, visitor, categories);
+		}
+	}
+
+	template<class Visitor>
+	void OcTree::VisitViews(const std::vector<const Collidable*> &colliders, Visitor &&visitor, unsigned int categories) const
+	{
+		unsigned int viewCount = std::min((unsigned int)colliders.size(), MAX_VIEW_COUNT);
+		if (viewCount == 0)
+			return;
+
+		uint32_t testMask = viewCount == 32 ? 0xffffffffu : (1u << viewCount) - 1;
+		VisitViewsTreeNode(*m_Root, testMask, 0, colliders, visitor, categories);
+		VisitViewsTreeNode(*m_StaticRoot, testMask, 0, colliders, visitor, categories);
+	}
+
+	template<class Visitor>
+	void OcTree::VisitViewsTreeNode(const OcTreeNode &treeNode, uint32_t testMask, uint32_t insideMask, 
+		const std::vector<const Collidable*> &colliders, Visitor &visitor, unsigned int categories) const
+	{
+		if (!treeNode.HasCategories(categories))
+			return;
+
+		// views containing this tree node contain it's childs too, views missing it are dropped.
+		for (unsigned int view = 0; view < 32 && (testMask >> view) != 0; view++)
+		{
+			uint32_t bit = 1u << view;
+			if ((testMask & bit) == 0)
+				continue;
+
+			Side result = colliders[view]->IsInside(treeNode.m_AABB);
+			if (result != Side::STRADDLE)
+				testMask &= ~bit;
+			if (result == Side::IN)
+				insideMask |= bit;
+		}
+
+		if ((testMask | insideMask) == 0)
+			return;
+
+		const unsigned int chunkSize = 64;
+		unsigned char results[chunkSize];
+		uint32_t viewMasks[chunkSize];
+
+		unsigned int sceneNodeCount = treeNode.m_SceneNodes.size();
+		for (unsigned int start = 0; start < sceneNodeCount; start += chunkSize)
+		{
+			unsigned int count = std::min(chunkSize, sceneNodeCount - start);
+			std::fill(viewMasks, viewMasks + count, insideMask);
+
+			for (unsigned int view = 0; view < 32 && (testMask >> view) != 0; view++)
+			{
+				uint32_t bit = 1u << view;
+				if ((testMask & bit) == 0)
+					continue;
+
+				colliders[view]->IsInsideFastBatch(treeNode.m_SceneNodeBounds, start, count, results);
+				for (unsigned int i = 0; i < count; i++)
+				{
+					if (results[i])
+						viewMasks[i] |= bit;
+				}
+			}
+
+			for (unsigned int i = 0; i < count; i++)
+			{
+				if (viewMasks[i] != 0 && (categories == 0 || (treeNode.m_SceneNodeCategories[start + i] & categories)))
+					visitor(treeNode.m_SceneNodes[start + i], viewMasks[i]);
+			}
+		}
+
+		for (int i = 0; i < 8; i++)
+		{
+			if (const OcTreeNode *childNode = treeNode.m_Childs[i].get())
+				VisitViewsTreeNode(*childNode, testMask, insideMask, colliders, visitor, categories);
+		}
+	}
 }
 
 #endif // _FURY_OCTREE_H_
\ No newline at end of file
@@ -1,8 +1,8 @@
+#include <algorithm>
 #include <math.h>
 
 #include "Fury/OcTreeNode.h"
 #include "Fury/OcTree.h"
-#include "Fury/Plane.h"
 #include "Fury/SceneNode.h"
 
 namespace fury
@@ -15,9 +15,9 @@ namespace fury
 
 	OcTreeNode::OcTreeNode(OcTree &manager, const OcTreeNode::Ptr &parent, Vector4 min, Vector4 max) :
 		m_TypeIndex(typeid(OcTreeNode)), m_Manager(manager), m_Parent(parent), 
-		m_AABB(min, max), m_IsLeaf(false), m_TotalSceneNodeCount(0)
+		m_AABB(min, max), m_IsLeaf(false), m_Depth(parent == nullptr ? 0 : parent->GetDepth() + 1), m_TotalSceneNodeCount(0)
 	{
-
+		std::fill(m_CategoryCounts, m_CategoryCounts + CATEGORY_COUNT, 0);
 	}
 
 	OcTreeNode::~OcTreeNode()
@@ -42,12 +42,41 @@ namespace fury
 		return ((boxSize.x <= halfBoxSize.x) && (boxSize.y <= halfBoxSize.y) && (boxSize.z <= halfBoxSize.z));
 	}
 
+	bool OcTreeNode::Contains(const BoxBounds &other) const
+	{
+		if (other.GetInfinite())
+			return false;
+
+		Vector4 treeMin = m_AABB.GetMin();
+		Vector4 treeMax = m_AABB.GetMax();
+
+		Vector4 otherMin = other.GetMin();
+		Vector4 otherMax = other.GetMax();
+
+		return otherMin.x > treeMin.x && otherMin.y > treeMin.y && otherMin.z > treeMin.z &&
+			otherMax.x < treeMax.x && otherMax.y < treeMax.y && otherMax.z < treeMax.z;
+	}
+
 	bool OcTreeNode::IsLeaf() const
 	{
 		return m_IsLeaf;
 	}
 
+	unsigned int OcTreeNode::GetDepth() const
+	{
+		return m_Depth;
+	}
+
 	OcTreeNode::Ptr OcTreeNode::GetFitNode(BoxBounds other)
+	{
+		int childIndex = GetFitChildIndex(other);
+		if (childIndex < 0)
+			return shared_from_this();
+
+		return GetOrCreateChild(childIndex);
+	}
+
+	int OcTreeNode::GetFitChildIndex(const BoxBounds &other) const
 	{
 		Vector4 treeCenter = m_AABB.GetCenter();
 		Vector4 treeMin = m_AABB.GetMin();
@@ -60,48 +89,44 @@ namespace fury
 
 		if (otherMin.x <= treeMin.x || otherMin.y <= treeMin.y || otherMin.z <= treeMin.z ||
 			otherMax.x >= treeMax.x || otherMax.y >= treeMax.y || otherMax.z >= treeMax.z)
-			return shared_from_this();
+			return -1;
 
 		// test with split planes to find the correct child to fit in.
+		// split planes face -z, -y, -x, a side is IN when the aabb lies at the negative side.
 
-		Plane splitPlanes[] = {
-			Plane(treeCenter, treeCenter + Vector4::YAxis, treeCenter + Vector4::XAxis),
-			Plane(treeCenter, treeCenter + Vector4::XAxis, treeCenter + Vector4::ZAxis),
-			Plane(treeCenter, treeCenter + Vector4::ZAxis, treeCenter + Vector4::YAxis)
-		};
-
-		bool collideResult[3];
+		float centers[3] = { treeCenter.z, treeCenter.y, treeCenter.x };
+		float mins[3] = { otherMin.z, otherMin.y, otherMin.x };
+		float maxs[3] = { otherMax.z, otherMax.y, otherMax.x };
 
 		// index = first + second * 2 + third * 4
 		int childIndex = 0;
 		for (int i = 0; i < 3; i++)
 		{
-			Side side = splitPlanes[i].IsInside(other);
-
-			if (side == Side::STRADDLE)
-			{
-				return shared_from_this();
-			}
-			else
-			{
-				collideResult[i] = side == Side::IN;
-				childIndex += (collideResult[i] ? 1 : 0) * (int)pow(2, i);
-			}
+			if (mins[i] <= centers[i] && maxs[i] > centers[i])
+				return -1;
+			else if (maxs[i] <= centers[i])
+				childIndex += 1 << i;
 		}
 
-		Vector4 treeExtents = m_AABB.GetExtents();
+		return childIndex;
+	}
 
-		OcTreeNode::Ptr child = m_Childs[childIndex];
+	OcTreeNode::Ptr OcTreeNode::GetOrCreateChild(unsigned int index)
+	{
+		OcTreeNode::Ptr child = m_Childs[index];
 		if (child == nullptr)
 		{
+			Vector4 treeCenter = m_AABB.GetCenter();
+			Vector4 treeExtents = m_AABB.GetExtents();
+
 			Vector4 aabbMax(
-				(collideResult[2] ? 0 : 1) * treeExtents.x + treeCenter.x,
-				(collideResult[1] ? 0 : 1) * treeExtents.y + treeCenter.y,
-				(collideResult[0] ? 0 : 1) * treeExtents.z + treeCenter.z,
+				(index & 4 ? 0 : 1) * treeExtents.x + treeCenter.x,
+				(index & 2 ? 0 : 1) * treeExtents.y + treeCenter.y,
+				(index & 1 ? 0 : 1) * treeExtents.z + treeCenter.z,
 				1.0f
 			);
 
-			m_Childs[childIndex] = child = OcTreeNode::Create(
+			m_Childs[index] = child = OcTreeNode::Create(
 				m_Manager, shared_from_this(), aabbMax - treeExtents, aabbMax);
 		}
 
@@ -134,19 +159,51 @@ namespace fury
 			return nullptr;
 	}
 
+	const BoxBoundsArray &OcTreeNode::GetSceneNodeBounds() const
+	{
+		return m_SceneNodeBounds;
+	}
+
 	unsigned int OcTreeNode::GetTotalSceneNodeCount() const
 	{
 		return m_TotalSceneNodeCount;
 	}
 
+	unsigned int OcTreeNode::GetSceneNodeCategories(unsigned int index) const
+	{
+		if (index < m_SceneNodeCategories.size())
+			return m_SceneNodeCategories[index];
+		else
+			return 0;
+	}
+
+	bool OcTreeNode::HasCategories(unsigned int categories) const
+	{
+		if (categories == 0)
+			return m_TotalSceneNodeCount > 0;
+
+		for (unsigned int i = 0; i < CATEGORY_COUNT; i++)
+		{
+			if ((categories & (1 << i)) && m_CategoryCounts[i] > 0)
+				return true;
+		}
+
+		return false;
+	}
+
 	void OcTreeNode::Clear()
 	{
 		for (auto &sceneNode : m_SceneNodes)
 			sceneNode->SetOcTreeNode(nullptr);
 		
 		m_SceneNodes.clear();
+		m_SceneNodeBounds.Clear();
+		m_SceneNodeCategories.clear();
 		m_IsLeaf = true;
 
+		m_TotalSceneNodeCount = 0;
+		std::fill(m_CategoryCounts, m_CategoryCounts + CATEGORY_COUNT, 0);
+
 		for (int i = 0; i < 8; i++)
 		{
 			if (auto child = m_Childs[i])
@@ -155,42 +212,115 @@ namespace fury
 		}	
 	}
 
-	void OcTreeNode::AddSceneNode(const std::shared_ptr<SceneNode> &node)
+	void OcTreeNode::AddSceneNode(const std::shared_ptr<SceneNode> &node, const OcTreeNode *until)
 	{
+		node->m_OcTreeIndex = m_SceneNodes.size();
 		m_SceneNodes.push_back(node);
+		m_SceneNodeBounds.Add(node->GetWorldAABB());
+		m_SceneNodeCategories.push_back(node->GetCategories());
 		node->SetOcTreeNode(shared_from_this());
-		IncreaseSceneNodeCount();
+		IncreaseSceneNodeCount(until);
+		IncreaseCategoryCount(m_SceneNodeCategories.back(), until);
 	}
 
-	void OcTreeNode::RemoveSceneNode(const std::shared_ptr<SceneNode> &node)
+	void OcTreeNode::RemoveSceneNode(const std::shared_ptr<SceneNode> &node, const OcTreeNode *until)
 	{
-		auto it = m_SceneNodes.begin();
-		while (it != m_SceneNodes.end())
-		{
-			if (*it == node)
-				break;
-			++it;
-		}
+		unsigned int index = node->m_OcTreeIndex;
+		if (index >= m_SceneNodes.size() || m_SceneNodes[index] != node)
+			return;
 
-		if (it != m_SceneNodes.end())
+		unsigned int categories = m_SceneNodeCategories[index];
+
+		// swap with the last one, order of scenenodes doesn't matter.
+		unsigned int last = m_SceneNodes.size() - 1;
+		if (index != last)
 		{
-			m_SceneNodes.erase(it);
-			node->SetOcTreeNode(nullptr);
-			DecreaseSceneNodeCount();
+			m_SceneNodes[index] = std::move(m_SceneNodes[last]);
+			m_SceneNodes[index]->m_OcTreeIndex = index;
+			m_SceneNodeCategories[index] = m_SceneNodeCategories[last];
 		}
+		m_SceneNodes.pop_back();
+		m_SceneNodeBounds.RemoveSwap(index);
+		m_SceneNodeCategories.pop_back();
+
+		node->SetOcTreeNode(nullptr);
+		DecreaseSceneNodeCount(until);
+		DecreaseCategoryCount(categories, until);
+
+		// moves inside the tree are recorded by OcTree::UpdateSceneNode.
+		if (until == nullptr)
+			m_Manager.RecordChange(node.get(), true);
+	}
+
+	void OcTreeNode::UpdateSceneNodeBounds(const std::shared_ptr<SceneNode> &node)
+	{
+		unsigned int index = node->m_OcTreeIndex;
+		if (index < m_SceneNodes.size() && m_SceneNodes[index] == node)
+			m_SceneNodeBounds.Set(index, node->GetWorldAABB());
+	}
+
+	void OcTreeNode::UpdateSceneNodeCategories(const std::shared_ptr<SceneNode> &node)
+	{
+		unsigned int index = node->m_OcTreeIndex;
+		if (index >= m_SceneNodes.size() || m_SceneNodes[index] != node)
+			return;
+
+		unsigned int categories = node->GetCategories();
+		if (categories == m_SceneNodeCategories[index])
+			return;
+
+		DecreaseCategoryCount(m_SceneNodeCategories[index]);
+		IncreaseCategoryCount(categories);
+		m_SceneNodeCategories[index] = categories;
 	}
 
-	void OcTreeNode::IncreaseSceneNodeCount()
+	void OcTreeNode::IncreaseSceneNodeCount(const OcTreeNode *until)
 	{
+		if (this == until)
+			return;
+
 		m_TotalSceneNodeCount++;
 		if (m_Parent != nullptr)
-			m_Parent->IncreaseSceneNodeCount();
+			m_Parent->IncreaseSceneNodeCount(until);
 	}
 
-	void OcTreeNode::DecreaseSceneNodeCount()
+	void OcTreeNode::DecreaseSceneNodeCount(const OcTreeNode *until)
 	{
+		if (this == until)
+			return;
+
 		m_TotalSceneNodeCount--;
 		if (m_Parent != nullptr)
-			m_Parent->DecreaseSceneNodeCount();
+			m_Parent->DecreaseSceneNodeCount(until);
+	}
+
+	void OcTreeNode::IncreaseCategoryCount(unsigned int categories, const OcTreeNode *until)
+	{
+		if (categories == 0)
+			return;
+
+		for (OcTreeNode *treeNode = this; treeNode != nullptr && treeNode != until; treeNode = treeNode->m_Parent.get())
+		{
+			for (unsigned int i = 0; i < CATEGORY_COUNT; i++)
+			{
+				if (categories & (1 << i))
+					treeNode->m_CategoryCounts[i]++;
+			}
+		}
+	}
+
+	void OcTreeNode::DecreaseCategoryCount(unsigned int categories, const OcTreeNode *until)
+	{
+		if (categories == 0)
+			return;
+
+		for (OcTreeNode *treeNode = this; treeNode != nullptr && treeNode != until; treeNode = treeNode->m_Parent.get())
+		{
+			for (unsigned int i = 0; i < CATEGORY_COUNT; i++)
+			{
+				if (categories & (1 << i))
+					treeNode->m_CategoryCounts[i]--;
+			}
+		}
 	}
 }
\ No newline at end of file
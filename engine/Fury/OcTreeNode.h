@@ -1,6 +1,7 @@
 #ifndef _FURY_OCTREENODE_H_
 #define _FURY_OCTREENODE_H_
 
+#include "Fury/BoxBoundsArray.h"
 #include "Fury/SceneNode.h"
 
 namespace fury
@@ -26,6 +27,9 @@ namespace fury
 
 		typedef std::shared_ptr<OcTreeNode> Ptr;
 
+		// one counter per SceneNodeCategory bit.
+		static const unsigned int CATEGORY_COUNT = 3;
+
 		static Ptr Create(OcTree &manager, const OcTreeNode::Ptr &parent, 
 			Vector4 min, Vector4 max);
 
@@ -41,12 +45,23 @@ namespace fury
 
 		std::vector<std::shared_ptr<SceneNode>> m_SceneNodes;
 
+		// world aabbs of m_SceneNodes, same index.
+		BoxBoundsArray m_SceneNodeBounds;
+
+		// SceneNodeCategory flags of m_SceneNodes, same index.
+		std::vector<unsigned int> m_SceneNodeCategories;
+
 		OcTreeNode::Ptr m_Parent;
 
 		bool m_IsLeaf;
 
+		unsigned int m_Depth;
+
 		unsigned int m_TotalSceneNodeCount;
 
+		// scenenodes of this subtree in each category.
+		unsigned int m_CategoryCounts[CATEGORY_COUNT];
+
 	public:
 
 		OcTreeNode(OcTree &manager, const OcTreeNode::Ptr &parent, 
@@ -62,29 +77,57 @@ namespace fury
 
 		bool IsTwiceSize(BoxBounds other) const;
 
+		// true if other lies strictly inside this node's aabb.
+		bool Contains(const BoxBounds &other) const;
+
 		bool IsLeaf() const;
 
+		unsigned int GetDepth() const;
+
 		OcTreeNode::Ptr GetFitNode(BoxBounds other);
 
+		// index of the child that other fits in, -1 if it should stay in this node.
+		int GetFitChildIndex(const BoxBounds &other) const;
+
 		std::shared_ptr<OcTreeNode> GetChildAt(unsigned int index) const;
 
 		unsigned int GetSceneNodeCount() const;
 
 		std::shared_ptr<SceneNode> GetSceneNodeAt(unsigned int index) const;
 
+		const BoxBoundsArray &GetSceneNodeBounds() const;
+
 		unsigned int GetTotalSceneNodeCount() const;
 
+		unsigned int GetSceneNodeCategories(unsigned int index) const;
+
+		// true if this subtree has a scenenode in any of categories, 0 matches every scenenode.
+		bool HasCategories(unsigned int categories) const;
+
 		void Clear();
 
-		void AddSceneNode(const std::shared_ptr<SceneNode> &node);
+		// scenenode counts are updated up to 'until', exclusive. nullptr means the root.
+		void AddSceneNode(const std::shared_ptr<SceneNode> &node, const OcTreeNode *until = nullptr);
+
+		void RemoveSceneNode(const std::shared_ptr<SceneNode> &node, const OcTreeNode *until = nullptr);
 
-		void RemoveSceneNode(const std::shared_ptr<SceneNode> &node);
+		// refresh cached world aabb of an attached scenenode.
+		void UpdateSceneNodeBounds(const std::shared_ptr<SceneNode> &node);
+
+		// recount an attached scenenode whose components changed.
+		void UpdateSceneNodeCategories(const std::shared_ptr<SceneNode> &node);
 
 	protected:
 
-		void IncreaseSceneNodeCount();
+		OcTreeNode::Ptr GetOrCreateChild(unsigned int index);
+
+		void IncreaseSceneNodeCount(const OcTreeNode *until = nullptr);
+
+		void DecreaseSceneNodeCount(const OcTreeNode *until = nullptr);
+
+		void IncreaseCategoryCount(unsigned int categories, const OcTreeNode *until = nullptr);
 
-		void DecreaseSceneNodeCount();
+		void DecreaseCategoryCount(unsigned int categories, const OcTreeNode *until = nullptr);
 
 	};
 }
@@ -0,0 +1,496 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FURY_OCCLUSION_SSE2
+#endif
+
+#include "Fury/BoxBounds.h"
+#include "Fury/BoxBoundsArray.h"
+#include "Fury/Camera.h"
+#include "Fury/Material.h"
+#include "Fury/Mesh.h"
+#include "Fury/MeshRender.h"
+#include "Fury/OcclusionCuller.h"
+#include "Fury/SceneManager.h"
+#include "Fury/SceneNode.h"
+#include "Fury/SphereBounds.h"
+
+namespace fury
+{
+	// clip space w below this is treated as crossing the near plane.
+	static const float MIN_CLIP_W = 1e-5f;
+
+	OcclusionCuller::Ptr OcclusionCuller::Create(unsigned int width, unsigned int height)
+	{
+		return std::make_shared<OcclusionCuller>(width, height);
+	}
+
+	OcclusionCuller::OcclusionCuller(unsigned int width, unsigned int height)
+	{
+		// simd path fills 4 pixels per step.
+		m_Width = (std::max(width, 4u) + 3) & ~3u;
+		m_Height = std::max(height, 1u);
+
+		unsigned int mipWidth = m_Width, mipHeight = m_Height;
+		while (true)
+		{
+			m_MipWidths.push_back(mipWidth);
+			m_MipHeights.push_back(mipHeight);
+			m_DepthMips.push_back(std::vector<float>(mipWidth * mipHeight, 1.0f));
+
+			if (mipWidth == 1 && mipHeight == 1)
+				break;
+
+			mipWidth = (mipWidth + 1) / 2;
+			mipHeight = (mipHeight + 1) / 2;
+		}
+	}
+
+	void OcclusionCuller::Setup(const std::shared_ptr<SceneManager> &sceneManager, const std::shared_ptr<SceneNode> &camera)
+	{
+		Begin(camera);
+
+		SceneManager::SceneNodes renderables;
+		sceneManager->GetVisibleRenderables(m_Frustum, renderables);
+
+		// marked occluders first, then larger ones.
+		std::vector<std::pair<float, SceneNode*>> candidates;
+		float screenArea = (float)(m_Width * m_Height);
+
+		for (auto &sceneNode : renderables)
+		{
+			auto render = sceneNode->GetComponent<MeshRender>();
+			auto mesh = render->GetMesh();
+			if (mesh->IsSkinnedMesh() || mesh->Positions.Data.empty())
+				continue;
+
+			if (render->GetOccluder())
+			{
+				candidates.push_back(std::make_pair(FLT_MAX, sceneNode.get()));
+				continue;
+			}
+
+			if (m_AutoOccluderSize <= 0.0f)
+				continue;
+
+			// transparent surfaces don't hide anything.
+			bool opaque = true;
+			for (unsigned int i = 0; i < render->GetMaterialCount() && opaque; i++)
+			{
+				auto material = render->GetMaterial(i);
+				opaque = material != nullptr && material->GetOpaque();
+			}
+
+			if (!opaque)
+				continue;
+
+			float rect[4], minDepth;
+			float coverage = 1.0f;
+			if (GetScreenRect(sceneNode->GetWorldAABB(), rect, minDepth))
+			{
+				float width = std::min(rect[2], (float)m_Width) - std::max(rect[0], 0.0f);
+				float height = std::min(rect[3], (float)m_Height) - std::max(rect[1], 0.0f);
+				coverage = std::max(width, 0.0f) * std::max(height, 0.0f) / screenArea;
+			}
+
+			if (coverage >= m_AutoOccluderSize)
+				candidates.push_back(std::make_pair(coverage, sceneNode.get()));
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [](const std::pair<float, SceneNode*> &a, const std::pair<float, SceneNode*> &b)
+		{
+			return a.first > b.first;
+		});
+
+		unsigned int count = std::min((unsigned int)candidates.size(), m_MaxOccluders);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			SceneNode *sceneNode = candidates[i].second;
+			RasterizeOccluder(sceneNode->GetComponent<MeshRender>()->GetMesh(), sceneNode->GetWorldMatrix());
+		}
+
+		End();
+	}
+
+	void OcclusionCuller::Begin(const std::shared_ptr<SceneNode> &camera)
+	{
+		auto cameraPtr = camera->GetComponent<Camera>();
+		Begin(cameraPtr->GetFrustum(), cameraPtr->GetProjectionMatrix() * camera->GetInvertWorldMatrix());
+	}
+
+	void OcclusionCuller::Begin(const Frustum &frustum, const Matrix4 &viewProjMatrix)
+	{
+		m_Frustum = frustum;
+		m_ViewProjMatrix = viewProjMatrix;
+		m_OccluderCount = 0;
+
+		std::fill(m_DepthMips[0].begin(), m_DepthMips[0].end(), 1.0f);
+	}
+
+	void OcclusionCuller::RasterizeOccluder(const std::shared_ptr<Mesh> &mesh, const Matrix4 &worldMatrix)
+	{
+		const std::vector<float> &positions = mesh->Positions.Data;
+		unsigned int vertexCount = positions.size() / 3;
+		if (vertexCount == 0)
+			return;
+
+		Matrix4 mvpMatrix = m_ViewProjMatrix * worldMatrix;
+
+		// pixel coords and depth, w < 0 marks vertices behind the near plane.
+		std::vector<Vector4> vertices(vertexCount);
+		for (unsigned int i = 0; i < vertexCount; i++)
+		{
+			Vector4 clip = mvpMatrix.Multiply(Vector4(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2], 1.0f));
+			if (clip.w < MIN_CLIP_W)
+			{
+				vertices[i] = Vector4(0.0f, 0.0f, 0.0f, -1.0f);
+				continue;
+			}
+
+			float invW = 1.0f / clip.w;
+			vertices[i] = Vector4(
+				(clip.x * invW * 0.5f + 0.5f) * m_Width,
+				(clip.y * invW * 0.5f + 0.5f) * m_Height,
+				clip.z * invW * 0.5f + 0.5f, 1.0f);
+		}
+
+		auto rasterize = [&](const std::vector<unsigned int> &indices)
+		{
+			for (unsigned int i = 0; i + 2 < indices.size(); i += 3)
+			{
+				const Vector4 &v0 = vertices[indices[i]];
+				const Vector4 &v1 = vertices[indices[i + 1]];
+				const Vector4 &v2 = vertices[indices[i + 2]];
+
+				// skipping triangles crossing the near plane only makes culling less aggressive.
+				if (v0.w < 0.0f || v1.w < 0.0f || v2.w < 0.0f)
+					continue;
+
+				RasterizeTriangle(v0, v1, v2);
+			}
+		};
+
+		if (mesh->GetSubMeshCount() > 0)
+		{
+			for (unsigned int i = 0; i < mesh->GetSubMeshCount(); i++)
+				rasterize(mesh->GetSubMeshAt(i)->Indices.Data);
+		}
+		else
+		{
+			rasterize(mesh->Indices.Data);
+		}
+
+		m_OccluderCount++;
+	}
+
+	void OcclusionCuller::End()
+	{
+		for (unsigned int level = 1; level < m_DepthMips.size(); level++)
+		{
+			const std::vector<float> &src = m_DepthMips[level - 1];
+			std::vector<float> &dst = m_DepthMips[level];
+
+			unsigned int srcWidth = m_MipWidths[level - 1], srcHeight = m_MipHeights[level - 1];
+			unsigned int dstWidth = m_MipWidths[level], dstHeight = m_MipHeights[level];
+
+			for (unsigned int y = 0; y < dstHeight; y++)
+			{
+				unsigned int y0 = y * 2, y1 = std::min(y0 + 1, srcHeight - 1);
+				for (unsigned int x = 0; x < dstWidth; x++)
+				{
+					unsigned int x0 = x * 2, x1 = std::min(x0 + 1, srcWidth - 1);
+					dst[y * dstWidth + x] = std::max(
+						std::max(src[y0 * srcWidth + x0], src[y0 * srcWidth + x1]),
+						std::max(src[y1 * srcWidth + x0], src[y1 * srcWidth + x1]));
+				}
+			}
+		}
+	}
+
+	bool OcclusionCuller::IsOccluded(const BoxBounds &aabb) const
+	{
+		if (m_OccluderCount == 0 || aabb.GetInfinite())
+			return false;
+
+		float rect[4], minDepth;
+		if (!GetScreenRect(aabb, rect, minDepth))
+			return false;
+
+		int minX = std::max((int)std::floor(rect[0]), 0);
+		int minY = std::max((int)std::floor(rect[1]), 0);
+		int maxX = std::min((int)std::floor(rect[2]), (int)m_Width - 1);
+		int maxY = std::min((int)std::floor(rect[3]), (int)m_Height - 1);
+
+		// outside the screen, leave it to the frustum.
+		if (minX > maxX || minY > maxY)
+			return false;
+
+		// pick the level where the rect covers 2x2 texels at most.
+		unsigned int level = 0;
+		while (level + 1 < m_DepthMips.size() && ((maxX >> level) - (minX >> level) > 1 || (maxY >> level) - (minY >> level) > 1))
+			level++;
+
+		const std::vector<float> &depths = m_DepthMips[level];
+		unsigned int mipWidth = m_MipWidths[level];
+
+		for (int y = minY >> level; y <= (maxY >> level); y++)
+		{
+			for (int x = minX >> level; x <= (maxX >> level); x++)
+			{
+				if (minDepth <= depths[y * mipWidth + x] + m_DepthBias)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	Side OcclusionCuller::IsInside(Vector4 point) const
+	{
+		Side side = m_Frustum.IsInside(point);
+		if (side == Side::OUT || IsOccluded(BoxBounds(point, point)))
+			return Side::OUT;
+
+		return side;
+	}
+
+	Side OcclusionCuller::IsInside(const BoxBounds &aabb) const
+	{
+		Side side = m_Frustum.IsInside(aabb);
+		if (side == Side::OUT || IsOccluded(aabb))
+			return Side::OUT;
+
+		// objects inside a visible aabb can still be occluded.
+		return Side::STRADDLE;
+	}
+
+	Side OcclusionCuller::IsInside(const SphereBounds &bsphere) const
+	{
+		Side side = m_Frustum.IsInside(bsphere);
+		if (side == Side::OUT)
+			return Side::OUT;
+
+		if (!bsphere.GetInfinite())
+		{
+			Vector4 center = bsphere.GetCenter();
+			float radius = bsphere.GetRadius();
+			Vector4 extents(radius, radius, radius, 0.0f);
+
+			if (IsOccluded(BoxBounds(center - extents, center + extents)))
+				return Side::OUT;
+		}
+
+		return Side::STRADDLE;
+	}
+
+	bool OcclusionCuller::IsInsideFast(const SphereBounds &bsphere) const
+	{
+		return IsInside(bsphere) != Side::OUT;
+	}
+
+	bool OcclusionCuller::IsInsideFast(const BoxBounds &aabb) const
+	{
+		return m_Frustum.IsInsideFast(aabb) && !IsOccluded(aabb);
+	}
+
+	bool OcclusionCuller::IsInsideFast(Vector4 point) const
+	{
+		return m_Frustum.IsInsideFast(point) && !IsOccluded(BoxBounds(point, point));
+	}
+
+	void OcclusionCuller::IsInsideFastBatch(const BoxBoundsArray &aabbs, unsigned int start, unsigned int count, unsigned char *results) const
+	{
+		m_Frustum.IsInsideFastBatch(aabbs, start, count, results);
+
+		if (m_OccluderCount == 0)
+			return;
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (results[i] && IsOccluded(aabbs.GetBoxBounds(start + i)))
+				results[i] = 0;
+		}
+	}
+
+	unsigned int OcclusionCuller::GetWidth() const
+	{
+		return m_Width;
+	}
+
+	unsigned int OcclusionCuller::GetHeight() const
+	{
+		return m_Height;
+	}
+
+	unsigned int OcclusionCuller::GetOccluderCount() const
+	{
+		return m_OccluderCount;
+	}
+
+	float OcclusionCuller::GetAutoOccluderSize() const
+	{
+		return m_AutoOccluderSize;
+	}
+
+	void OcclusionCuller::SetAutoOccluderSize(float size)
+	{
+		m_AutoOccluderSize = size;
+	}
+
+	unsigned int OcclusionCuller::GetMaxOccluders() const
+	{
+		return m_MaxOccluders;
+	}
+
+	void OcclusionCuller::SetMaxOccluders(unsigned int count)
+	{
+		m_MaxOccluders = count;
+	}
+
+	float OcclusionCuller::GetDepthBias() const
+	{
+		return m_DepthBias;
+	}
+
+	void OcclusionCuller::SetDepthBias(float bias)
+	{
+		m_DepthBias = bias;
+	}
+
+	float OcclusionCuller::GetDepth(unsigned int x, unsigned int y) const
+	{
+		return m_DepthMips[0][y * m_Width + x];
+	}
+
+	bool OcclusionCuller::GetScreenRect(const BoxBounds &aabb, float *rect, float &minDepth) const
+	{
+		Vector4 min = aabb.GetMin();
+		Vector4 max = aabb.GetMax();
+
+		rect[0] = rect[1] = FLT_MAX;
+		rect[2] = rect[3] = -FLT_MAX;
+		minDepth = FLT_MAX;
+
+		for (int i = 0; i < 8; i++)
+		{
+			Vector4 corner(i & 4 ? max.x : min.x, i & 2 ? max.y : min.y, i & 1 ? max.z : min.z, 1.0f);
+			Vector4 clip = m_ViewProjMatrix.Multiply(corner);
+			if (clip.w < MIN_CLIP_W)
+				return false;
+
+			float invW = 1.0f / clip.w;
+			float x = (clip.x * invW * 0.5f + 0.5f) * m_Width;
+			float y = (clip.y * invW * 0.5f + 0.5f) * m_Height;
+
+			rect[0] = std::min(rect[0], x);
+			rect[1] = std::min(rect[1], y);
+			rect[2] = std::max(rect[2], x);
+			rect[3] = std::max(rect[3], y);
+			minDepth = std::min(minDepth, clip.z * invW * 0.5f + 0.5f);
+		}
+
+		return true;
+	}
+
+	void OcclusionCuller::RasterizeTriangle(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2)
+	{
+		float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+		if (std::abs(area) < 1e-8f)
+			return;
+
+		// counter clockwise, so inside pixels have positive edge values.
+		const Vector4 &a = v0;
+		const Vector4 &b = area > 0.0f ? v1 : v2;
+		const Vector4 &c = area > 0.0f ? v2 : v1;
+		area = std::abs(area);
+
+		int minX = std::max((int)std::floor(std::min(a.x, std::min(b.x, c.x))), 0);
+		int minY = std::max((int)std::floor(std::min(a.y, std::min(b.y, c.y))), 0);
+		int maxX = std::min((int)std::ceil(std::max(a.x, std::max(b.x, c.x))), (int)m_Width - 1);
+		int maxY = std::min((int)std::ceil(std::max(a.y, std::max(b.y, c.y))), (int)m_Height - 1);
+		if (minX > maxX || minY > maxY)
+			return;
+
+		// start on a 4 pixel boundary, width is a multiple of 4 so rows never overflow.
+		minX &= ~3;
+
+		// edge e(p) = dx * (p.y - from.y) - dy * (p.x - from.x), sampled at pixel centers.
+		const Vector4 *from[3] = { &b, &c, &a };
+		const Vector4 *to[3] = { &c, &a, &b };
+
+		float stepX[3], stepY[3], origin[3];
+		float px = minX + 0.5f, py = minY + 0.5f;
+		for (int i = 0; i < 3; i++)
+		{
+			stepX[i] = -(to[i]->y - from[i]->y);
+			stepY[i] = to[i]->x - from[i]->x;
+			origin[i] = stepY[i] * (py - from[i]->y) + stepX[i] * (px - from[i]->x);
+		}
+
+		// depth is linear in screen space, edge i weights the vertex opposite to it.
+		float invArea = 1.0f / area;
+		float depthX = (stepX[0] * a.z + stepX[1] * b.z + stepX[2] * c.z) * invArea;
+		float depthY = (stepY[0] * a.z + stepY[1] * b.z + stepY[2] * c.z) * invArea;
+		float depthOrigin = (origin[0] * a.z + origin[1] * b.z + origin[2] * c.z) * invArea;
+
+		std::vector<float> &depths = m_DepthMips[0];
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			float row = (float)(y - minY);
+			float e0 = origin[0] + stepY[0] * row;
+			float e1 = origin[1] + stepY[1] * row;
+			float e2 = origin[2] + stepY[2] * row;
+			float depth = depthOrigin + depthY * row;
+
+			float *dst = &depths[y * m_Width];
+			int x = minX;
+
+#if defined(FURY_OCCLUSION_SSE2)
+			const __m128 offsets = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+			const __m128 zero = _mm_setzero_ps();
+
+			__m128 edge0 = _mm_add_ps(_mm_set1_ps(e0), _mm_mul_ps(offsets, _mm_set1_ps(stepX[0])));
+			__m128 edge1 = _mm_add_ps(_mm_set1_ps(e1), _mm_mul_ps(offsets, _mm_set1_ps(stepX[1])));
+			__m128 edge2 = _mm_add_ps(_mm_set1_ps(e2), _mm_mul_ps(offsets, _mm_set1_ps(stepX[2])));
+			__m128 depth4 = _mm_add_ps(_mm_set1_ps(depth), _mm_mul_ps(offsets, _mm_set1_ps(depthX)));
+
+			const __m128 edgeStep0 = _mm_set1_ps(stepX[0] * 4.0f);
+			const __m128 edgeStep1 = _mm_set1_ps(stepX[1] * 4.0f);
+			const __m128 edgeStep2 = _mm_set1_ps(stepX[2] * 4.0f);
+			const __m128 depthStep = _mm_set1_ps(depthX * 4.0f);
+
+			for (; x <= maxX; x += 4)
+			{
+				__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)), _mm_cmpge_ps(edge2, zero));
+				if (_mm_movemask_ps(inside))
+				{
+					__m128 current = _mm_loadu_ps(dst + x);
+					__m128 nearer = _mm_min_ps(current, depth4);
+					_mm_storeu_ps(dst + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, current)));
+				}
+
+				edge0 = _mm_add_ps(edge0, edgeStep0);
+				edge1 = _mm_add_ps(edge1, edgeStep1);
+				edge2 = _mm_add_ps(edge2, edgeStep2);
+				depth4 = _mm_add_ps(depth4, depthStep);
+			}
+#endif
+
+			// scalar path on other platforms.
+			for (; x <= maxX; x++)
+			{
+				float column = (float)(x - minX);
+				if (e0 + stepX[0] * column >= 0.0f && e1 + stepX[1] * column >= 0.0f && e2 + stepX[2] * column >= 0.0f)
+				{
+					float pixelDepth = depth + depthX * column;
+					if (pixelDepth < dst[x])
+						dst[x] = pixelDepth;
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
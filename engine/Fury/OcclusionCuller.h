@@ -0,0 +1,137 @@
+#ifndef _FURY_OCCLUSION_CULLER_H_
+#define _FURY_OCCLUSION_CULLER_H_
+
+#include <vector>
+#include <memory>
+
+#include "Fury/Collidable.h"
+#include "Fury/Frustum.h"
+#include "Fury/Matrix4.h"
+
+namespace fury
+{
+	class BoxBounds;
+
+	class Mesh;
+
+	class SceneManager;
+
+	class SceneNode;
+
+	/**
+	 *	Software occlusion culling on a low resolution depth buffer.
+	 *
+	 *	Occluder meshes are rasterized on cpu, then a max depth pyramid is built,
+	 *	an aabb is hidden if it's nearest depth lies behind the farthest occluder depth of the texels it covers.
+	 *
+	 *	As a collidable it tests the camera's frustum first, then the depth pyramid,
+	 *	so it can be passed to SceneManager queries directly.
+	 *	Tree nodes inside the frustum are reported as Side::STRADDLE, so their contents are tested one by one.
+	 */
+	class FURY_API OcclusionCuller : public Collidable
+	{
+	public:
+
+		typedef std::shared_ptr<OcclusionCuller> Ptr;
+
+		static Ptr Create(unsigned int width = 256, unsigned int height = 128);
+
+	protected:
+
+		unsigned int m_Width;
+
+		unsigned int m_Height;
+
+		// level 0 is the rasterized depth buffer,
+		// texels of level n keep the farthest depth of 2x2 texels of level n - 1.
+		std::vector<std::vector<float>> m_DepthMips;
+
+		std::vector<unsigned int> m_MipWidths;
+
+		std::vector<unsigned int> m_MipHeights;
+
+		Frustum m_Frustum;
+
+		Matrix4 m_ViewProjMatrix;
+
+		unsigned int m_OccluderCount = 0;
+
+		// renderables covering this fraction of screen become occluders, 0 to use marked ones only.
+		float m_AutoOccluderSize = 0.1f;
+
+		unsigned int m_MaxOccluders = 32;
+
+		// an aabb's nearest depth has to be this much behind the occluders' to be hidden.
+		// occluders are also tested, and their aabb depth doesn't exactly match their rasterized depth,
+		// without it a flat occluder facing the camera could hide itself.
+		float m_DepthBias = 1e-5f;
+
+	public:
+
+		// width is rounded up to a multiple of 4.
+		OcclusionCuller(unsigned int width, unsigned int height);
+
+		// picks occluders from the scene visible to camera, and rasterizes them.
+		void Setup(const std::shared_ptr<SceneManager> &sceneManager, const std::shared_ptr<SceneNode> &camera);
+
+		// clears the depth buffer.
+		void Begin(const std::shared_ptr<SceneNode> &camera);
+
+		void Begin(const Frustum &frustum, const Matrix4 &viewProjMatrix);
+
+		void RasterizeOccluder(const std::shared_ptr<Mesh> &mesh, const Matrix4 &worldMatrix);
+
+		// builds the depth pyramid, call it before tests.
+		void End();
+
+		// returns true if aabb is completely hidden behind rasterized occluders.
+		bool IsOccluded(const BoxBounds &aabb) const;
+
+		virtual Side IsInside(Vector4 point) const;
+
+		virtual Side IsInside(const BoxBounds &aabb) const;
+
+		virtual Side IsInside(const SphereBounds &bsphere) const;
+
+		virtual bool IsInsideFast(const SphereBounds &bsphere) const;
+
+		virtual bool IsInsideFast(const BoxBounds &aabb) const;
+
+		virtual bool IsInsideFast(Vector4 point) const;
+
+		virtual void IsInsideFastBatch(const BoxBoundsArray &aabbs, unsigned int start, unsigned int count, unsigned char *results) const;
+
+		unsigned int GetWidth() const;
+
+		unsigned int GetHeight() const;
+
+		unsigned int GetOccluderCount() const;
+
+		float GetAutoOccluderSize() const;
+
+		void SetAutoOccluderSize(float size);
+
+		unsigned int GetMaxOccluders() const;
+
+		void SetMaxOccluders(unsigned int count);
+
+		float GetDepthBias() const;
+
+		// in [0, 1] depth units, 1e-5 by default.
+		void SetDepthBias(float bias);
+
+		// depth of level 0 in [0, 1], 1 where nothing is rasterized.
+		float GetDepth(unsigned int x, unsigned int y) const;
+
+	protected:
+
+		// projects aabb to pixel rect [minX, minY, maxX, maxY] and it's nearest depth.
+		// returns false if aabb crosses the near plane.
+		bool GetScreenRect(const BoxBounds &aabb, float *rect, float &minDepth) const;
+
+		// vertices are in pixel coords, with depth as z.
+		void RasterizeTriangle(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2);
+	};
+}
+
+#endif // _FURY_OCCLUSION_CULLER_H_
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "Fury/BoxBounds.h"
 #include "Fury/Camera.h"
+#include "Fury/DetailCuller.h"
 #include "Fury/Log.h"
 #include "Fury/Light.h"
 #include "Fury/EnumUtil.h"
@@ -15,6 +16,7 @@
 #include "Fury/MathUtil.h"
 #include "Fury/Mesh.h"
 #include "Fury/MeshRender.h"
+#include "Fury/OcclusionCuller.h"
 #include "Fury/Pipeline.h"
 #include "Fury/Pass.h"
 #include "Fury/RenderUtil.h"
@@ -24,6 +26,7 @@
 #include "Fury/Shader.h"
 #include "Fury/SphereBounds.h"
 #include "Fury/Texture.h"
+#include "Fury/VisibilityCache.h"
 
 namespace fury
 {
@@ -45,6 +48,10 @@ namespace fury
 		m_Switches.reset();
 
 		m_EntityManager = EntityManager::Create();
+
+		m_VisibilityCache = VisibilityCache::Create();
+
+		m_OcclusionCuller = OcclusionCuller::Create();
 	}
 
 	Pipeline::~Pipeline()
@@ -261,14 +268,56 @@ namespace fury
 		m_CurrentCamera = ptr;
 	}
 
+	std::shared_ptr<VisibilityCache> Pipeline::GetVisibilityCache() const
+	{
+		return m_VisibilityCache;
+	}
+
+	std::shared_ptr<OcclusionCuller> Pipeline::GetOcclusionCuller() const
+	{
+		return m_OcclusionCuller;
+	}
+
+	int Pipeline::GetShadowLODBias() const
+	{
+		return m_ShadowLODBias;
+	}
+
+	void Pipeline::SetShadowLODBias(int bias)
+	{
+		m_ShadowLODBias = bias;
+	}
+
+	std::shared_ptr<Mesh> Pipeline::GetShadowMesh(const std::shared_ptr<SceneNode> &caster) const
+	{
+		auto render = caster->GetComponent<MeshRender>();
+		if (render->GetLODCount() <= 1)
+			return render->GetMesh();
+
+		auto camera = m_CurrentCamera->GetComponent<Camera>();
+		unsigned int lod = render->GetLOD(caster->GetCurrentLOD(camera), camera->GetScreenSize(caster->GetWorldAABB()), m_ShadowLODBias);
+		return render->GetLODMesh(lod);
+	}
+
 	void Pipeline::FilterNodes(const Collidable &collider, std::vector<std::shared_ptr<SceneNode>> &possibles, std::vector<std::shared_ptr<SceneNode>> &collisions)
 	{
 		collisions.erase(collisions.begin(), collisions.end());
 
-		for (auto possible : possibles)
+		unsigned int count = possibles.size();
+		if (count == 0)
+			return;
+
+		m_FilterBounds.Resize(count);
+		for (unsigned int i = 0; i < count; i++)
+			m_FilterBounds.Set(i, possibles[i]->GetWorldAABB());
+
+		m_FilterResults.resize(count);
+		collider.IsInsideFastBatch(m_FilterBounds, 0, count, m_FilterResults.data());
+
+		for (unsigned int i = 0; i < count; i++)
 		{
-			if (collider.IsInsideFast(possible->GetWorldAABB()))
-				collisions.push_back(possible);
+			if (m_FilterResults[i])
+				collisions.push_back(possibles[i]);
 		}
 	}
 
@@ -338,52 +387,145 @@ namespace fury
 		return projMatrix * cropMatrix;
 	}
 
+	std::vector<Frustum> Pipeline::GetCascadeFrustums() const
+	{
+		auto camera = m_CurrentCamera->GetComponent<Camera>();
+
+		std::vector<Frustum> frustums(CASCADE_SPLIT_COUNT);
+		float average = (camera->GetFar() - camera->GetNear()) / (float)CASCADE_SPLIT_COUNT;
+		float curNear = camera->GetNear();
+		float curFar = curNear;
+		for (unsigned int i = 0; i < CASCADE_SPLIT_COUNT; i++)
+		{
+			curFar += average;
+			frustums[i] = camera->GetFrustum(curNear, curFar);
+			curNear += average;
+		}
+
+		return frustums;
+	}
+
+	void Pipeline::CullViews(const std::shared_ptr<SceneManager> &sceneManager, const Collidable *mainCollider, const std::shared_ptr<RenderQuery> &renderQuery)
+	{
+		auto camera = m_CurrentCamera->GetComponent<Camera>();
+		bool cascaded = IsSwitchOn(PipelineSwitch::CASCADED_SHADOW_MAP);
+
+		if (renderQuery != nullptr)
+		{
+			renderQuery->Clear();
+			renderQuery->lodCamera = camera;
+		}
+
+		for (auto &casters : m_CascadeCasters)
+			casters.clear();
+
+		m_CascadeCastersValid = cascaded;
+
+		std::vector<Frustum> frustums;
+		if (cascaded)
+			frustums = GetCascadeFrustums();
+
+		// use camera aabb to include more possible shadow casters to cast shadows.
+		BoxBounds shadowBounds = camera->GetShadowBounds();
+		bool useShadowBounds = cascaded && camera->GetShadowBounds(false).GetExtents().SquareLength() > 0;
+
+		const unsigned int lightCategory = (unsigned int)SceneNodeCategory::LIGHT;
+		const unsigned int renderableCategory = (unsigned int)SceneNodeCategory::RENDERABLE;
+		const unsigned int casterCategory = (unsigned int)SceneNodeCategory::SHADOW_CASTER;
+
+		// views: mainCollider if any, then the splits, then shadowBounds.
+		// every view is wrapped by camera's draw distance and min screen size of it's categories.
+		std::vector<const Collidable*> colliders;
+		std::vector<DetailCuller> detailCullers;
+		detailCullers.reserve(CASCADE_SPLIT_COUNT + 3);
+
+		auto addView = [&](const Collidable &collider, unsigned int viewCategories) -> uint32_t
+		{
+			detailCullers.emplace_back(collider, *camera, viewCategories);
+			colliders.push_back(&detailCullers.back());
+			return 1u << (colliders.size() - 1);
+		};
+
+		uint32_t lightMask = 0, renderableMask = 0, shadowBoundsMask = 0;
+		unsigned int categories = casterCategory;
+
+		if (mainCollider != nullptr && renderQuery != nullptr)
+		{
+			// lights and renderables share one view unless their thresholds differ.
+			if (camera->GetDrawDistance(SceneNodeCategory::LIGHT) == camera->GetDrawDistance(SceneNodeCategory::RENDERABLE) &&
+				camera->GetMinScreenSize(SceneNodeCategory::LIGHT) == camera->GetMinScreenSize(SceneNodeCategory::RENDERABLE))
+			{
+				lightMask = renderableMask = addView(*mainCollider, lightCategory | renderableCategory);
+			}
+			else
+			{
+				lightMask = addView(*mainCollider, lightCategory);
+				renderableMask = addView(*mainCollider, renderableCategory);
+			}
+			categories |= lightCategory | renderableCategory;
+		}
+
+		unsigned int firstSplit = colliders.size();
+		for (auto &frustum : frustums)
+			addView(frustum, casterCategory);
+
+		if (useShadowBounds)
+			shadowBoundsMask = addView(shadowBounds, casterCategory);
+
+		if (colliders.empty())
+			return;
+
+		sceneManager->WalkSceneViews(colliders, [&](const std::shared_ptr<SceneNode> &sceneNode, uint32_t viewMask)
+		{
+			auto render = sceneNode->GetComponent<MeshRender>();
+			bool renderable = render != nullptr && render->GetRenderable();
+
+			if ((viewMask & lightMask) && sceneNode->GetComponent<Light>() != nullptr)
+				renderQuery->AddLight(sceneNode);
+
+			if ((viewMask & renderableMask) && renderable)
+				renderQuery->AddRenderable(sceneNode);
+
+			if (!renderable || !render->GetMesh()->GetCastShadows())
+				return;
+
+			// shadow bounds only widen the first split.
+			if (viewMask & shadowBoundsMask)
+				viewMask |= 1u << firstSplit;
+
+			for (unsigned int i = 0; i < frustums.size(); i++)
+			{
+				if (viewMask & (1u << (firstSplit + i)))
+					m_CascadeCasters[i].push_back(sceneNode);
+			}
+		}, categories);
+	}
+
 	std::pair<std::shared_ptr<Texture>, std::vector<Matrix4>> Pipeline::DrawCascadedShadowMap(const std::shared_ptr<SceneManager> &sceneManager, const std::shared_ptr<Pass> &pass, const std::shared_ptr<SceneNode> &node)
 	{
-		const int numSplit = 4;
+		const int numSplit = CASCADE_SPLIT_COUNT;
 
 		// get pointers
 		auto depth_shader = GetShaderByName("leagcy_depth_shader");
-		auto depth_buffer = Texture::GetTempory(1024, 1024, 4, TextureFormat::DEPTH24, TextureType::TEXTURE_2D_ARRAY);
+		auto depth_buffer = Texture::GetTempory(1024, 1024, numSplit, TextureFormat::DEPTH24, TextureType::TEXTURE_2D_ARRAY);
 		depth_buffer->SetBorderColor(Color::White);
 		depth_buffer->SetWrapMode(WrapMode::CLAMP_TO_BORDER);
 
 		// for debug
 		Pipeline::Active->GetEntityManager()->Add(depth_buffer);
 
-		auto camera = m_CurrentCamera->GetComponent<Camera>();
-
 		Matrix4 lightMatrix;
 		lightMatrix.Rotate(MathUtil::AxisRadToQuat(Vector4::XAxis, MathUtil::DegToRad * 90.0f));
 		lightMatrix = lightMatrix * node->GetInvertWorldMatrix();
 
 		// build frustums
-		std::array<Frustum, numSplit> frustums;
-		float average = (camera->GetFar() - camera->GetNear()) / (float)numSplit;
-		float curNear = camera->GetNear();
-		float curFar = curNear;
-		for (int i = 0; i < numSplit; i++)
-		{
-			curFar += average;
-			frustums[i] = camera->GetFrustum(curNear, curFar);
-			curNear += average;
-		}
+		std::vector<Frustum> frustums = GetCascadeFrustums();
 
-		// find shadow casters
-		fury::SceneManager::SceneNodes casterAll;
-		sceneManager->GetVisibleShadowCasters(camera->GetFrustum(), casterAll);
+		// find shadow casters, usually culled together with the camera's render query.
+		if (!m_CascadeCastersValid)
+			CullViews(sceneManager, nullptr, nullptr);
 
-		std::array<fury::SceneManager::SceneNodes, numSplit> casterArrays;
-		for (int i = 0; i < numSplit; i++)
-		{
-			auto &casters = casterArrays[i];
-			auto &frustum = frustums[i];
-			FilterNodes(frustum, casterAll, casters);
-		}
-
-		// use camera aabb to include more possible shadow casters to cast shadows.
-		if (camera->GetShadowBounds(false).GetExtents().SquareLength() > 0)
-			sceneManager->GetVisibleShadowCasters(camera->GetShadowBounds(), casterArrays[0], false);
+		auto &casterArrays = m_CascadeCasters;
 
 		// build projection/crop matrices
 		std::array<Matrix4, numSplit> projMatrices;
@@ -423,8 +565,7 @@ namespace fury
 				auto &casters = casterArrays[i];
 				for (auto &caster : casters)
 				{
-					auto casterRender = caster->GetComponent<MeshRender>();
-					auto casterMesh = casterRender->GetMesh();
+					auto casterMesh = GetShadowMesh(caster);
 
 					depth_shader->BindMesh(casterMesh);
 					depth_shader->BindMatrix(Matrix4::WORLD_MATRIX, &caster->GetWorldMatrix().Raw[0]);
@@ -471,11 +612,14 @@ namespace fury
 
 		// find shadow casters
 		fury::SceneManager::SceneNodes casters;
-		sceneManager->GetVisibleShadowCasters(camFrustum, casters, false);
+		sceneManager->GetVisibleShadowCasters(DetailCuller(camFrustum, *camera, (unsigned int)SceneNodeCategory::SHADOW_CASTER), casters, false);
 
 		// use camera aabb to include more possible shadow casters to cast shadows.
 		if (camera->GetShadowBounds(false).GetExtents().SquareLength() > 0)
-			sceneManager->GetVisibleShadowCasters(camera->GetShadowBounds(), casters, false);
+		{
+			BoxBounds shadowBounds = camera->GetShadowBounds();
+			sceneManager->GetVisibleShadowCasters(DetailCuller(shadowBounds, *camera, (unsigned int)SceneNodeCategory::SHADOW_CASTER), casters, false);
+		}
 
 		// gen projection matrix for light.
 		Matrix4 projMatrix = GetCropMatrix(lightMatrix, camFrustum, casters);
@@ -502,8 +646,7 @@ namespace fury
 
 			for (auto &caster : casters)
 			{
-				auto casterRender = caster->GetComponent<MeshRender>();
-				auto casterMesh = casterRender->GetMesh();
+				auto casterMesh = GetShadowMesh(caster);
 
 				depth_shader->BindMesh(casterMesh);
 				depth_shader->BindMatrix(Matrix4::WORLD_MATRIX, &caster->GetWorldMatrix().Raw[0]);
@@ -537,9 +680,8 @@ namespace fury
 		auto radius = light->GetRadius();
 		auto lightSphere = SphereBounds(node->GetWorldPosition(), radius);
 
-		// TODO: filter casters for all six directions.
 		fury::SceneManager::SceneNodes casters;
-		sceneManager->GetVisibleShadowCasters(lightSphere, casters);
+		sceneManager->GetVisibleShadowCasters(DetailCuller(lightSphere, *camera, (unsigned int)SceneNodeCategory::SHADOW_CASTER), casters);
 
 		float aspect = (float)depth_buffer->GetWidth() / depth_buffer->GetHeight();
 		Matrix4 projMatrix;
@@ -557,6 +699,31 @@ namespace fury
 		dirMatrices[4].LookAt(lightPos, lightPos + Vector4(0.0f, 0.0f, 1.0f), Vector4(0.0f, -1.0f, 0.0f));
 		dirMatrices[5].LookAt(lightPos, lightPos + Vector4(0.0f, 0.0f, -1.0f), Vector4(0.0f, -1.0f, 0.0f));
 
+		// bit i of a caster's face mask is set if it's inside face i's 90 degree frustum.
+		unsigned int casterCount = casters.size();
+		m_FaceMasks.assign(casterCount, 0);
+		if (casterCount > 0)
+		{
+			m_FilterBounds.Resize(casterCount);
+			for (unsigned int i = 0; i < casterCount; i++)
+				m_FilterBounds.Set(i, casters[i]->GetWorldAABB());
+
+			m_FilterResults.resize(casterCount);
+			for (int i = 0; i < 6; i++)
+			{
+				Frustum faceFrustum;
+				faceFrustum.Setup(MathUtil::DegToRad * 90.0f, aspect, 1.0f, radius);
+				faceFrustum.Transform(dirMatrices[i].Inverse());
+				faceFrustum.IsInsideFastBatch(m_FilterBounds, 0, casterCount, m_FilterResults.data());
+
+				for (unsigned int j = 0; j < casterCount; j++)
+				{
+					if (m_FilterResults[j])
+						m_FaceMasks[j] |= 1 << i;
+				}
+			}
+		}
+
 		// draw casters to depth map, aka shadow map.
 		{
 			m_SharedPass->RemoveAllTextures();
@@ -584,15 +751,18 @@ namespace fury
 				m_SharedPass->SetCubeTextureIndex(i);
 				m_SharedPass->Clear(m_SharedPass->GetClearMode(), m_SharedPass->GetClearColor());
 
-				for (auto &caster : casters)
+				auto ivm = dirMatrices[i];
+				depth_shader->BindMatrix(Matrix4::INVERT_VIEW_MATRIX, &ivm.Raw[0]);
+
+				for (unsigned int j = 0; j < casterCount; j++)
 				{
-					auto casterRender = caster->GetComponent<MeshRender>();
-					auto casterMesh = casterRender->GetMesh();
+					if ((m_FaceMasks[j] & (1 << i)) == 0)
+						continue;
 
-					auto ivm = dirMatrices[i];
+					auto &caster = casters[j];
+					auto casterMesh = GetShadowMesh(caster);
 
 					depth_shader->BindMesh(casterMesh);
-					depth_shader->BindMatrix(Matrix4::INVERT_VIEW_MATRIX, &ivm.Raw[0]);
 					depth_shader->BindMatrix(Matrix4::WORLD_MATRIX, &caster->GetWorldMatrix().Raw[0]);
 
 					glDrawElements(GL_TRIANGLES, casterMesh->Indices.Data.size(), GL_UNSIGNED_INT, 0);
@@ -640,8 +810,10 @@ namespace fury
 		projMatrix.PerspectiveFov(light->GetOutterAngle(), aspect, 1.0f, radius);
 
 		// find shadow casters
+		auto camera = m_CurrentCamera->GetComponent<Camera>();
+
 		fury::SceneManager::SceneNodes casters;
-		sceneManager->GetVisibleRenderables(frustum, casters);
+		sceneManager->GetVisibleRenderables(DetailCuller(frustum, *camera, (unsigned int)SceneNodeCategory::SHADOW_CASTER), casters);
 
 		// draw casters to depth map, aka shadow map.
 		{
@@ -665,8 +837,7 @@ namespace fury
 
 			for (auto &caster : casters)
 			{
-				auto casterRender = caster->GetComponent<MeshRender>();
-				auto casterMesh = casterRender->GetMesh();
+				auto casterMesh = GetShadowMesh(caster);
 
 				depth_shader->BindMesh(casterMesh);
 				depth_shader->BindMatrix(Matrix4::WORLD_MATRIX, &caster->GetWorldMatrix().Raw[0]);
@@ -1,11 +1,13 @@
 #ifndef _FURY_PIPELINE_H_
 #define _FURY_PIPELINE_H_
 
+#include <array>
 #include <memory>
 #include <unordered_map>
 #include <string>
 #include <bitset>
 
+#include "Fury/BoxBoundsArray.h"
 #include "Fury/Entity.h"
 
 namespace fury
@@ -36,12 +38,17 @@ namespace fury
 
 	class RenderQuery;
 
+	class OcclusionCuller;
+
+	class VisibilityCache;
+
 	enum class PipelineSwitch : unsigned int
 	{
 		CASCADED_SHADOW_MAP = 0, 
 		MESH_BOUNDS, 
 		LIGHT_BOUNDS, 
 		CUSTOM_BOUNDS, 
+		OCCLUSION_CULLING, 
 		LENGTH
 	};
 
@@ -55,6 +62,8 @@ namespace fury
 
 		static Ptr Active;
 
+		static const unsigned int CASCADE_SPLIT_COUNT = 4;
+
 	protected:
 
 		std::shared_ptr<EntityManager> m_EntityManager;
@@ -77,6 +86,29 @@ namespace fury
 
 		Matrix4 m_OffsetMatrix;
 
+		// reused by FilterNodes, so batch culling doesn't allocate every frame.
+		BoxBoundsArray m_FilterBounds;
+
+		std::vector<unsigned char> m_FilterResults;
+
+		// cube faces each caster is drawn to, reused by DrawPointLightShadowMap.
+		std::vector<unsigned char> m_FaceMasks;
+
+		// last visible set of each camera.
+		std::shared_ptr<VisibilityCache> m_VisibilityCache;
+
+		// used by main camera's query when OCCLUSION_CULLING is on.
+		std::shared_ptr<OcclusionCuller> m_OcclusionCuller;
+
+		// shadow casters of each cascade split of current camera, filled by CullViews.
+		std::array<std::vector<std::shared_ptr<SceneNode>>, CASCADE_SPLIT_COUNT> m_CascadeCasters;
+
+		// reset at the start of every frame.
+		bool m_CascadeCastersValid = false;
+
+		// shadow maps draw casters this many lods coarser than the camera would.
+		int m_ShadowLODBias = 1;
+
 		// end rendering
 
 		// debug
@@ -124,12 +156,28 @@ namespace fury
 
 		void SetCurrentCamera(const std::shared_ptr<SceneNode> &ptr);
 
+		std::shared_ptr<VisibilityCache> GetVisibilityCache() const;
+
+		std::shared_ptr<OcclusionCuller> GetOcclusionCuller() const;
+
+		int GetShadowLODBias() const;
+
+		void SetShadowLODBias(int bias);
+
 		// begin shaodw mapping
 
 		void FilterNodes(const Collidable &collider, std::vector<std::shared_ptr<SceneNode>> &possibles, std::vector<std::shared_ptr<SceneNode>> &collisions);
 
 		Matrix4 GetCropMatrix(Matrix4 lightMatrix, Frustum frustum, std::vector<std::shared_ptr<SceneNode>> &casters);
 
+		// current camera's frustum split into CASCADE_SPLIT_COUNT parts of equal depth.
+		std::vector<Frustum> GetCascadeFrustums() const;
+
+		// culls mainCollider and current camera's cascade splits in one scene walk.
+		// lights and renderables visible in mainCollider go to renderQuery, shadow casters of each split to m_CascadeCasters.
+		// mainCollider can be nullptr to cull cascades only, cascades are skipped if CASCADED_SHADOW_MAP is off.
+		void CullViews(const std::shared_ptr<SceneManager> &sceneManager, const Collidable *mainCollider, const std::shared_ptr<RenderQuery> &renderQuery);
+
 		std::pair<std::shared_ptr<Texture>, std::vector<Matrix4>> DrawCascadedShadowMap(const std::shared_ptr<SceneManager> &sceneManager, const std::shared_ptr<Pass> &pass, const std::shared_ptr<SceneNode> &node);
 
 		std::pair<std::shared_ptr<Texture>, Matrix4> DrawDirLightShadowMap(const std::shared_ptr<SceneManager> &sceneManager, const std::shared_ptr<Pass> &pass, const std::shared_ptr<SceneNode> &node);
@@ -145,6 +193,9 @@ namespace fury
 		void DrawDebug(const std::shared_ptr<RenderQuery> &query);
 
 		void SortPassByIndex();
+
+		// caster's mesh for shadow maps, lod is picked by it's screen size in current camera plus m_ShadowLODBias.
+		std::shared_ptr<Mesh> GetShadowMesh(const std::shared_ptr<SceneNode> &caster) const;
 	};
 }
 
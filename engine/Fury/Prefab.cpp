@@ -0,0 +1,136 @@
+#include "Fury/ComponentStore.h"
+#include "Fury/Log.h"
+#include "Fury/Prefab.h"
+#include "Fury/SceneNode.h"
+#include "Fury/SceneNodeIndex.h"
+
+namespace fury
+{
+	Prefab::Ptr Prefab::Create(const std::string &name, const std::shared_ptr<SceneNode> &source)
+	{
+		return std::make_shared<Prefab>(name, source);
+	}
+
+	Prefab::Prefab(const std::string &name, const std::shared_ptr<SceneNode> &source) :
+		Entity(name), m_Source(source)
+	{
+		m_TypeIndex = typeid(Prefab);
+	}
+
+	bool Prefab::Load(const void* wrapper, bool object)
+	{
+		if (object && !IsObject(wrapper))
+		{
+			FURYE << "Json node is not an object!";
+			return false;
+		}
+
+		if (!Entity::Load(wrapper, false))
+			return false;
+
+		auto sourceWrapper = FindMember(wrapper, "source");
+		if (sourceWrapper == nullptr)
+		{
+			FURYE << "source not found!";
+			return false;
+		}
+
+		auto source = SceneNode::Create("temp");
+		if (!source->Load(sourceWrapper))
+			return false;
+
+		m_Source = source;
+		return true;
+	}
+
+	void Prefab::Save(void* wrapper, bool object)
+	{
+		if (object)
+			StartObject(wrapper);
+
+		Entity::Save(wrapper, false);
+
+		if (m_Source != nullptr)
+		{
+			SaveKey(wrapper, "source");
+			m_Source->Save(wrapper);
+		}
+
+		if (object)
+			EndObject(wrapper);
+	}
+
+	std::shared_ptr<SceneNode> Prefab::GetSource() const
+	{
+		return m_Source;
+	}
+
+	void Prefab::SetSource(const std::shared_ptr<SceneNode> &source)
+	{
+		m_Source = source;
+	}
+
+	std::shared_ptr<SceneNode> Prefab::Instantiate(const std::string &name)
+	{
+		auto node = SceneNode::Create(name);
+		Instantiate(node);
+		return node;
+	}
+
+	void Prefab::Instantiate(const std::shared_ptr<SceneNode> &node, const Overrides &overrides)
+	{
+		if (m_Source == nullptr)
+		{
+			FURYW << "Prefab " << m_Name << " has no source!";
+			return;
+		}
+
+		std::unordered_map<size_t, unsigned int> counts;
+
+		node->m_Prefab = shared_from_this();
+		InstantiateNode(m_Source, node, 0, overrides, counts);
+	}
+
+	void Prefab::InstantiateNode(const std::shared_ptr<SceneNode> &source, const std::shared_ptr<SceneNode> &node, 
+		size_t pathHash, const Overrides &overrides, std::unordered_map<size_t, unsigned int> &counts) const
+	{
+		node->SetLocalPosition(source->GetLocalPosition());
+		node->SetLocalRoattion(source->GetLocalRoattion());
+		node->SetLocalScale(source->GetLocalScale());
+
+		for (auto &slot : source->m_Components)
+		{
+			// a copy, adding to the store may move it's pool.
+			auto component = source->m_ComponentStore->Get(slot.typeId, slot.handle);
+			if (component->GetShareable())
+				node->AddSharedComponent(slot.typeId, component);
+			else
+				node->AddComponent(component->Clone());
+		}
+
+		// after components, some of them set their own model aabb when attaching.
+		node->SetModelAABB(source->GetModelAABB());
+
+		for (auto &sourceChild : source->m_Childs)
+		{
+			auto child = SceneNode::Create(sourceChild->GetName());
+			child->m_PrefabChild = true;
+
+			// same depth first order as SceneNode::SavePrefabOverrides.
+			size_t childPath = SceneNodeIndex::CombinePath(pathHash, sourceChild->GetHashCode());
+			unsigned int index = counts[childPath]++;
+
+			InstantiateNode(sourceChild, child, childPath, overrides, counts);
+
+			// after it's own prefab childs, childs it adds were saved after them too.
+			auto it = overrides.find(childPath);
+			if (it != overrides.end() && index < it->second.size() && it->second[index] != nullptr)
+			{
+				if (!child->LoadPrefabOverride(it->second[index]))
+					FURYW << "Prefab " << m_Name << " failed to apply override of " << child->GetName() << "!";
+			}
+
+			node->AddChild(child);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef _FURY_PREFAB_H_
+#define _FURY_PREFAB_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "Fury/Entity.h"
+
+namespace fury
+{
+	class SceneNode;
+
+	/**
+	 *	A scenenode hierarchy to spawn instances of.
+	 *
+	 *	Instances reference the source's shareable components instead of cloning them,
+	 *	SceneNode::GetUniqueComponent gives an instance it's own copy before modifying one.
+	 *	Other components are cloned, transforms and model aabbs are copied.
+	 *
+	 *	Scenes save an instance root as a reference to it's prefab, with it's transform, unique components
+	 *	and childs added after spawning. Changes below it are saved as overrides, one per changed prefab child,
+	 *	keyed by it's path hash relative to the instance root: it's transform if it differs from the source's, 
+	 *	it's unique components and childs added to it. Removed or renamed prefab childs come back on load.
+	 */
+	class FURY_API Prefab : public Entity, public std::enable_shared_from_this<Prefab>
+	{
+	public:
+
+		typedef std::shared_ptr<Prefab> Ptr;
+
+		static Ptr Create(const std::string &name, const std::shared_ptr<SceneNode> &source = nullptr);
+
+		// json wrappers of overrides by path hash, the path hash of the instance root is 0.
+		// prefab childs sharing a path hash are told apart by their depth first order, nullptr if one has none.
+		typedef std::unordered_map<size_t, std::vector<const void*>> Overrides;
+
+	protected:
+
+		// never added to a scene, instances are built from it.
+		std::shared_ptr<SceneNode> m_Source;
+
+	public:
+
+		Prefab(const std::string &name, const std::shared_ptr<SceneNode> &source = nullptr);
+
+		virtual bool Load(const void* wrapper, bool object = true) override;
+
+		virtual void Save(void* wrapper, bool object = true) override;
+
+		std::shared_ptr<SceneNode> GetSource() const;
+
+		// existing instances keep what they were built from.
+		void SetSource(const std::shared_ptr<SceneNode> &source);
+
+		std::shared_ptr<SceneNode> Instantiate(const std::string &name);
+
+		// builds the instance in node, which should have no components or childs yet.
+		// overrides are applied to the prefab childs they belong to, see SceneNode::Load.
+		void Instantiate(const std::shared_ptr<SceneNode> &node, const Overrides &overrides = Overrides());
+
+	protected:
+
+		// counts is the number of prefab childs built so far for each path hash.
+		void InstantiateNode(const std::shared_ptr<SceneNode> &source, const std::shared_ptr<SceneNode> &node, 
+			size_t pathHash, const Overrides &overrides, std::unordered_map<size_t, unsigned int> &counts) const;
+	};
+}
+
+#endif // _FURY_PREFAB_H_
\ No newline at end of file
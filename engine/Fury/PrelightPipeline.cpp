@@ -13,6 +13,7 @@
 #include "Fury/Mesh.h"
 #include "Fury/MeshRender.h"
 #include "Fury/MeshUtil.h"
+#include "Fury/OcclusionCuller.h"
 #include "Fury/Pass.h"
 #include "Fury/PrelightPipeline.h"
 #include "Fury/RenderQuery.h"
@@ -22,6 +23,7 @@
 #include "Fury/Shader.h"
 #include "Fury/SphereBounds.h"
 #include "Fury/Texture.h"
+#include "Fury/VisibilityCache.h"
 
 namespace fury
 {
@@ -54,6 +56,10 @@ namespace fury
 		else
 			SetSwitch(PipelineSwitch::CASCADED_SHADOW_MAP, true);
 
+		boolValue = false;
+		LoadMemberValue(wrapper, "occlusion_culling", boolValue);
+		SetSwitch(PipelineSwitch::OCCLUSION_CULLING, boolValue);
+
 		return true;
 	}
 
@@ -67,6 +73,9 @@ namespace fury
 		SaveKey(wrapper, "cascaded_shadow_map");
 		SaveValue(wrapper, IsSwitchOn(PipelineSwitch::CASCADED_SHADOW_MAP));
 
+		SaveKey(wrapper, "occlusion_culling");
+		SaveValue(wrapper, IsSwitchOn(PipelineSwitch::OCCLUSION_CULLING));
+
 		if (object)
 			EndObject(wrapper);
 	}
@@ -81,10 +90,28 @@ namespace fury
 		m_CurrentMesh = nullptr;
 		SortPassByIndex();
 
-		// find visible nodes
-		RenderQuery::Ptr query = RenderQuery::Create();
-		sceneManager->GetRenderQuery(m_CurrentCamera->GetComponent<Camera>()->GetFrustum(), query);
-		query->Sort(m_CurrentCamera->GetWorldPosition());
+		// find visible nodes, reuses last frame's result if nothing changed.
+		// occlusion depends on other scenenodes, so occlusion culled queries aren't cached.
+		// cascade shadow casters are culled in the same walk whenever the query is rebuilt.
+		m_CascadeCastersValid = false;
+
+		RenderQuery::Ptr query;
+		if (IsSwitchOn(PipelineSwitch::OCCLUSION_CULLING))
+		{
+			m_OcclusionCuller->Setup(sceneManager, m_CurrentCamera);
+
+			query = RenderQuery::Create();
+			CullViews(sceneManager, m_OcclusionCuller.get(), query);
+			query->Sort(m_CurrentCamera->GetWorldPosition());
+		}
+		else if (m_VisibilityCache->GetRenderQuery(sceneManager, m_CurrentCamera, query, 
+			[&](const Collidable &collider, const RenderQuery::Ptr &renderQuery)
+		{
+			CullViews(sceneManager, &collider, renderQuery);
+		}))
+		{
+			query->Sort(m_CurrentCamera->GetWorldPosition());
+		}
 
 		// draw passes
 
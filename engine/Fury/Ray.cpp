@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Fury/BoxBounds.h"
+#include "Fury/Matrix4.h"
+#include "Fury/Ray.h"
+#include "Fury/SphereBounds.h"
+
+namespace fury
+{
+	Ray::Ray()
+	{
+		Set(Vector4(0.0f, 0.0f, 0.0f, 1.0f), Vector4(0.0f, 0.0f, -1.0f, 0.0f));
+	}
+
+	Ray::Ray(Vector4 origin, Vector4 direction, float maxDistance)
+	{
+		Set(origin, direction, maxDistance);
+	}
+
+	void Ray::Set(Vector4 origin, Vector4 direction, float maxDistance)
+	{
+		m_Origin = Vector4(origin, 1.0f);
+		m_Direction = Vector4(direction.Normalized(), 0.0f);
+		m_MaxDistance = maxDistance;
+
+		// zero components give infinite slabs, Intersects checks them separately.
+		float inv[3];
+		float dir[3] = { m_Direction.x, m_Direction.y, m_Direction.z };
+		for (int i = 0; i < 3; i++)
+			inv[i] = dir[i] != 0.0f ? 1.0f / dir[i] : std::numeric_limits<float>::max();
+
+		m_InvDirection = Vector4(inv[0], inv[1], inv[2], 0.0f);
+	}
+
+	Vector4 Ray::GetOrigin() const
+	{
+		return m_Origin;
+	}
+
+	Vector4 Ray::GetDirection() const
+	{
+		return m_Direction;
+	}
+
+	float Ray::GetMaxDistance() const
+	{
+		return m_MaxDistance;
+	}
+
+	void Ray::SetMaxDistance(float distance)
+	{
+		m_MaxDistance = distance;
+	}
+
+	Vector4 Ray::GetPoint(float distance) const
+	{
+		return m_Origin + m_Direction * distance;
+	}
+
+	bool Ray::Intersects(const BoxBounds &aabb, float &near, float &far) const
+	{
+		near = 0.0f;
+		far = m_MaxDistance;
+
+		if (aabb.GetInfinite())
+			return true;
+
+		Vector4 min = aabb.GetMin();
+		Vector4 max = aabb.GetMax();
+
+		float mins[3] = { min.x, min.y, min.z };
+		float maxs[3] = { max.x, max.y, max.z };
+		float origin[3] = { m_Origin.x, m_Origin.y, m_Origin.z };
+		float dir[3] = { m_Direction.x, m_Direction.y, m_Direction.z };
+		float inv[3] = { m_InvDirection.x, m_InvDirection.y, m_InvDirection.z };
+
+		for (int i = 0; i < 3; i++)
+		{
+			if (dir[i] == 0.0f)
+			{
+				// parallel to this slab.
+				if (origin[i] < mins[i] || origin[i] > maxs[i])
+					return false;
+
+				continue;
+			}
+
+			float t0 = (mins[i] - origin[i]) * inv[i];
+			float t1 = (maxs[i] - origin[i]) * inv[i];
+			if (t0 > t1)
+				std::swap(t0, t1);
+
+			near = std::max(near, t0);
+			far = std::min(far, t1);
+
+			if (near > far)
+				return false;
+		}
+
+		return true;
+	}
+
+	bool Ray::Intersects(const SphereBounds &bsphere, float &distance) const
+	{
+		if (bsphere.GetInfinite())
+		{
+			distance = 0.0f;
+			return true;
+		}
+
+		Vector4 offset = m_Origin - bsphere.GetCenter();
+		float radius = bsphere.GetRadius();
+
+		float b = offset * m_Direction;
+		float c = offset * offset - radius * radius;
+
+		// origin inside the sphere.
+		if (c <= 0.0f)
+		{
+			distance = 0.0f;
+			return true;
+		}
+
+		float discriminant = b * b - c;
+		if (b > 0.0f || discriminant < 0.0f)
+			return false;
+
+		distance = -b - std::sqrt(discriminant);
+		return distance <= m_MaxDistance;
+	}
+
+	bool Ray::Intersects(Vector4 v0, Vector4 v1, Vector4 v2, float &distance) const
+	{
+		// Moller-Trumbore
+		const float epsilon = 1e-8f;
+
+		Vector4 edge1 = v1 - v0;
+		Vector4 edge2 = v2 - v0;
+
+		Vector4 p = m_Direction.CrossProduct(edge2);
+		float det = edge1 * p;
+		if (std::abs(det) < epsilon)
+			return false;
+
+		float invDet = 1.0f / det;
+
+		Vector4 s = m_Origin - v0;
+		float u = (s * p) * invDet;
+		if (u < 0.0f || u > 1.0f)
+			return false;
+
+		Vector4 q = s.CrossProduct(edge1);
+		float v = (m_Direction * q) * invDet;
+		if (v < 0.0f || u + v > 1.0f)
+			return false;
+
+		distance = (edge2 * q) * invDet;
+		return distance >= 0.0f && distance <= m_MaxDistance;
+	}
+
+	Ray Ray::Transform(const Matrix4 &matrix) const
+	{
+		Vector4 origin = matrix.Multiply(m_Origin);
+		Vector4 direction = matrix.Multiply(m_Direction);
+
+		// keep the end point, so max distance follows the matrix's scale.
+		float maxDistance = m_MaxDistance;
+		if (maxDistance < std::numeric_limits<float>::max())
+			maxDistance = Vector4(direction.x, direction.y, direction.z, 0.0f).Length() * m_MaxDistance;
+
+		return Ray(origin, direction, maxDistance);
+	}
+
+	Side Ray::IsInside(Vector4 point) const
+	{
+		return IsInsideFast(point) ? Side::STRADDLE : Side::OUT;
+	}
+
+	Side Ray::IsInside(const BoxBounds &aabb) const
+	{
+		// a ray never contains a volume, so childs of a hit tree node are always tested.
+		float near, far;
+		return Intersects(aabb, near, far) ? Side::STRADDLE : Side::OUT;
+	}
+
+	Side Ray::IsInside(const SphereBounds &bsphere) const
+	{
+		float distance;
+		return Intersects(bsphere, distance) ? Side::STRADDLE : Side::OUT;
+	}
+
+	bool Ray::IsInsideFast(const SphereBounds &bsphere) const
+	{
+		float distance;
+		return Intersects(bsphere, distance);
+	}
+
+	bool Ray::IsInsideFast(const BoxBounds &aabb) const
+	{
+		float near, far;
+		return Intersects(aabb, near, far);
+	}
+
+	bool Ray::IsInsideFast(Vector4 point) const
+	{
+		const float epsilon = 1e-5f;
+
+		float distance = (point - m_Origin) * m_Direction;
+		if (distance < 0.0f || distance > m_MaxDistance)
+			return false;
+
+		return (point - GetPoint(distance)).SquareLength() <= epsilon * epsilon;
+	}
+}
\ No newline at end of file
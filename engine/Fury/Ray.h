@@ -0,0 +1,72 @@
+#ifndef _FURY_RAY_H_
+#define _FURY_RAY_H_
+
+#include <limits>
+
+#include "Fury/Collidable.h"
+#include "Fury/Vector4.h"
+
+namespace fury
+{
+	class Matrix4;
+
+	// a half line from origin, limited by max distance.
+	// as a collidable it reports aabbs the ray passes through as Side::STRADDLE,
+	// so SceneManager::WalkScene can collect ray cast candidates.
+	class FURY_API Ray : public Collidable
+	{
+	protected:
+
+		Vector4 m_Origin;
+
+		// normalized.
+		Vector4 m_Direction;
+
+		Vector4 m_InvDirection;
+
+		float m_MaxDistance;
+
+	public:
+
+		Ray();
+
+		Ray(Vector4 origin, Vector4 direction, float maxDistance = std::numeric_limits<float>::max());
+
+		void Set(Vector4 origin, Vector4 direction, float maxDistance = std::numeric_limits<float>::max());
+
+		Vector4 GetOrigin() const;
+
+		Vector4 GetDirection() const;
+
+		float GetMaxDistance() const;
+
+		void SetMaxDistance(float distance);
+
+		Vector4 GetPoint(float distance) const;
+
+		// distances where the ray enters and leaves aabb, clamped to [0, maxDistance].
+		bool Intersects(const BoxBounds &aabb, float &near, float &far) const;
+
+		bool Intersects(const SphereBounds &bsphere, float &distance) const;
+
+		// two sided triangle test.
+		bool Intersects(Vector4 v0, Vector4 v1, Vector4 v2, float &distance) const;
+
+		// returns the ray in matrix's space, distances are NOT preserved under scaling.
+		Ray Transform(const Matrix4 &matrix) const;
+
+		virtual Side IsInside(Vector4 point) const;
+
+		virtual Side IsInside(const BoxBounds &aabb) const;
+
+		virtual Side IsInside(const SphereBounds &bsphere) const;
+
+		virtual bool IsInsideFast(const SphereBounds &bsphere) const;
+
+		virtual bool IsInsideFast(const BoxBounds &aabb) const;
+
+		virtual bool IsInsideFast(Vector4 point) const;
+	};
+}
+
+#endif // _FURY_RAY_H_
\ No newline at end of file
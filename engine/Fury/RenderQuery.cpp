@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <functional>
 
+#include "Fury/Camera.h"
 #include "Fury/RenderQuery.h"
 #include "Fury/SceneNode.h"
 #include "Fury/MeshRender.h"
@@ -20,7 +21,15 @@ namespace fury
 	void RenderQuery::AddRenderable(const std::shared_ptr<SceneNode> &node)
 	{
 		auto render = node->GetComponent<MeshRender>();
-		auto mesh = render->GetMesh();
+
+		unsigned int lod = 0;
+		if (lodCamera != nullptr && render->GetLODCount() > 1)
+		{
+			lod = render->GetLOD(node->GetCurrentLOD(lodCamera), lodCamera->GetScreenSize(node->GetWorldAABB()));
+			node->SetCurrentLOD(lodCamera, lod);
+		}
+
+		auto mesh = render->GetLODMesh(lod);
 		auto subMeshCount = mesh->GetSubMeshCount();
 		if (subMeshCount > 0)
 		{
@@ -29,18 +38,18 @@ namespace fury
 				auto subMesh = mesh->GetSubMeshAt(i);
 				auto material = render->GetMaterial(i);
 				if (material->GetOpaque())
-					opaqueUnits.push_back(RenderUnit(node, mesh, material, i));
+					opaqueUnits.push_back(RenderUnit(node, mesh, material, i, lod));
 				else
-					transparentUnits.push_back(RenderUnit(node, mesh, material, i));
+					transparentUnits.push_back(RenderUnit(node, mesh, material, i, lod));
 			}
 		}
 		else
 		{
 			auto material = render->GetMaterial();
 			if (material->GetOpaque())
-				opaqueUnits.push_back(RenderUnit(node, mesh, material, -1));
+				opaqueUnits.push_back(RenderUnit(node, mesh, material, -1, lod));
 			else
-				transparentUnits.push_back(RenderUnit(node, mesh, material, -1));
+				transparentUnits.push_back(RenderUnit(node, mesh, material, -1, lod));
 		}
 
 		renderableNodes.push_back(node);
@@ -8,6 +8,8 @@
 
 namespace fury
 {
+	class Camera;
+
 	class SceneNode;
 
 	class Material;
@@ -24,13 +26,17 @@ namespace fury
 
 		int subMesh = 0;
 
+		// mesh is the MeshRender's mesh for this lod.
+		unsigned int lod = 0;
+
 		RenderUnit(const std::shared_ptr<SceneNode> &node, const std::shared_ptr<Mesh> &mesh,
-			const std::shared_ptr<Material> &material, int subMesh)
+			const std::shared_ptr<Material> &material, int subMesh, unsigned int lod = 0)
 		{
 			this->node = node;
 			this->mesh = mesh;
 			this->material = material;
 			this->subMesh = subMesh;
+			this->lod = lod;
 		}
 	};
 
@@ -50,6 +56,10 @@ namespace fury
 
 		std::vector<std::shared_ptr<SceneNode>> lightNodes;
 
+		// if set, AddRenderable picks mesh lods by screen size in this camera.
+		// not reset by Clear.
+		std::shared_ptr<Camera> lodCamera;
+
 		void AddRenderable(const std::shared_ptr<SceneNode> &node);
 
 		void AddLight(const std::shared_ptr<SceneNode> &node);
@@ -1,10 +1,14 @@
 #include "Fury/Scene.h"
+#include "Fury/ComponentStore.h"
 #include "Fury/OcTree.h"
 #include "Fury/EntityManager.h"
 #include "Fury/SceneNode.h"
+#include "Fury/SceneNodeIndex.h"
 #include "Fury/Log.h"
 #include "Fury/Material.h"
 #include "Fury/Mesh.h"
+#include "Fury/Prefab.h"
+#include "Fury/TransformSystem.h"
 
 namespace fury
 {
@@ -40,6 +44,14 @@ namespace fury
 
 		m_EntityManager = EntityManager::Create();
 		m_RootNode = SceneNode::Create("RootNode");
+
+		// nodes move their components here when they're attached below the root.
+		m_ComponentStore = ComponentStore::Create();
+		m_RootNode->SetComponentStore(m_ComponentStore);
+
+		// nodes join the index when they're attached below the root.
+		m_NodeIndex = SceneNodeIndex::Create();
+		m_RootNode->m_NodeIndex = m_NodeIndex;
 	}
 
 	Scene::~Scene()
@@ -99,6 +111,21 @@ namespace fury
 			return false;
 		}
 
+		// load prefabs, before nodes that reference them
+		if (IsArray(wrapper, "prefabs") && !LoadArray(wrapper, "prefabs", [&](const void* node) -> bool
+		{
+			auto prefab = Prefab::Create("temp");
+			if (!prefab->Load(node))
+				return false;
+
+			m_EntityManager->Add(prefab);
+			return true;
+		}))
+		{
+			FURYE << "Error serializing prefabs!";
+			return false;
+		}
+
 		// load nodes
 		if (auto rootNodeWrapper = FindMember(wrapper, "nodes"))
 		{
@@ -112,7 +139,9 @@ namespace fury
 		}
 
 		// setup scene manager
+		FlushTransforms();
 		m_SceneManager->AddSceneNodeRecursively(m_RootNode);
+		m_SceneManager->Flush();
 
 		return true;
 	}
@@ -144,6 +173,19 @@ namespace fury
 		});
 		EndArray(wrapper);
 
+		// save prefabs
+		if (m_EntityManager->Count<Prefab>() > 0)
+		{
+			SaveKey(wrapper, "prefabs");
+			StartArray(wrapper);
+			m_EntityManager->ForEach<Prefab>([&](const Prefab::Ptr &ptr) -> bool
+			{
+				ptr->Save(wrapper);
+				return true;
+			});
+			EndArray(wrapper);
+		}
+
 		// save nodes
 		SaveKey(wrapper, "nodes");
 		m_RootNode->Save(wrapper);
@@ -167,6 +209,16 @@ namespace fury
 		return m_EntityManager;
 	}
 
+	std::shared_ptr<ComponentStore> Scene::GetComponentStore() const
+	{
+		return m_ComponentStore;
+	}
+
+	std::shared_ptr<SceneNodeIndex> Scene::GetNodeIndex() const
+	{
+		return m_NodeIndex;
+	}
+
 	std::string Scene::GetWorkingDir() const
 	{
 		return m_WorkingDir;
@@ -176,4 +228,11 @@ namespace fury
 	{
 		m_WorkingDir = path;
 	}
+
+	unsigned int Scene::FlushTransforms()
+	{
+		unsigned int count = m_RootNode->GetTransformSystem()->Update();
+		m_SceneManager->Flush();
+		return count;
+	}
 }
\ No newline at end of file
@@ -18,6 +18,10 @@ namespace fury
 
 	class Mesh;
 
+	class ComponentStore;
+
+	class SceneNodeIndex;
+
 	class FURY_API Scene : public Entity 
 	{
 	public:
@@ -40,6 +44,13 @@ namespace fury
 
 		std::shared_ptr<EntityManager> m_EntityManager;
 
+		// components of nodes below m_RootNode and it's own, for walking all components of a type.
+		// other scenes, prefab sources and detached nodes use their own stores.
+		std::shared_ptr<ComponentStore> m_ComponentStore;
+
+		// name and path lookup of nodes below m_RootNode.
+		std::shared_ptr<SceneNodeIndex> m_NodeIndex;
+
 		std::string m_WorkingDir;
 
 	public:
@@ -60,10 +71,20 @@ namespace fury
 
 		std::shared_ptr<EntityManager> GetEntityManager() const;
 
+		std::shared_ptr<ComponentStore> GetComponentStore() const;
+
+		std::shared_ptr<SceneNodeIndex> GetNodeIndex() const;
+
 		// extra resources prepends this to filepath when loading.
 		std::string GetWorkingDir() const;
 
 		void SetWorkingDir(const std::string &path);
+
+		// updates TransformSystem::Active, which is shared by every scene and by scenenodes outside them, ie. prefab sources.
+		// so all dirty transforms are recomputed, not only this scene's. each scene manager gets it's moved scenenodes in one batch,
+		// OnTransformChange is emitted once per moved scenenode, then this scene's manager is flushed. call once per frame before culling.
+		// returns number of moved scenenodes in all scenes.
+		unsigned int FlushTransforms();
 		
 	};
 }
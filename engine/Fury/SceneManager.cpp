@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <unordered_map>
+
+#include "Fury/Light.h"
+#include "Fury/Mesh.h"
+#include "Fury/MeshRender.h"
+#include "Fury/Ray.h"
+#include "Fury/RenderQuery.h"
+#include "Fury/SceneManager.h"
+#include "Fury/SceneNode.h"
+#include "Fury/SphereBounds.h"
+#include "Fury/TriangleBVH.h"
+
+namespace fury
+{
+	const unsigned int SceneManager::MAX_CHANGE_LOG = 1024;
+
+	const unsigned int SceneManager::MAX_VIEW_COUNT = 32;
+
+	void SceneManager::AddSceneNodeRecursively(const std::shared_ptr<SceneNode> &sceneNode)
+	{
+		AddSceneNode(sceneNode);
+
+		for (unsigned int i = 0; i < sceneNode->GetChildCount(); i++)
+			AddSceneNodeRecursively(sceneNode->GetChildAt(i));
+	}
+
+	void SceneManager::UpdateSceneNodes(const SceneNodes &sceneNodes)
+	{
+		for (auto &sceneNode : sceneNodes)
+			UpdateSceneNode(sceneNode);
+	}
+
+	void SceneManager::Flush()
+	{
+
+	}
+
+	void SceneManager::GetRenderQuery(const Collidable &collider, const std::shared_ptr<RenderQuery> &renderQuery, bool clear) const
+	{
+		if (clear)
+			renderQuery->Clear();
+
+		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode)
+		{
+			if (sceneNode->GetComponent<Light>() != nullptr)
+				renderQuery->AddLight(sceneNode);
+			
+			if (auto render = sceneNode->GetComponent<MeshRender>())
+			{
+				if (render->GetRenderable())
+					renderQuery->AddRenderable(sceneNode);
+			}
+		});
+	}
+
+	void SceneManager::GetVisibleSceneNodes(const Collidable &collider, SceneNodes &sceneNodes, bool clear) const
+	{
+		if (clear)
+			sceneNodes.clear();
+
+		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode) 
+		{
+			sceneNodes.push_back(sceneNode);
+		});
+	}
+
+	void SceneManager::GetVisibleRenderables(const Collidable &collider, SceneNodes &renderables, bool clear) const
+	{
+		if (clear)
+			renderables.clear();
+
+		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode)
+		{
+			auto render = sceneNode->GetComponent<MeshRender>();
+			if (render != nullptr && render->GetRenderable())
+				renderables.push_back(sceneNode);
+		});
+	}
+
+	void SceneManager::GetVisibleShadowCasters(const Collidable &collider, SceneNodes &renderables, bool clear) const
+	{
+		if (clear)
+			renderables.clear();
+
+		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode)
+		{
+			auto render = sceneNode->GetComponent<MeshRender>();
+			if (render != nullptr && render->GetRenderable() && render->GetMesh()->GetCastShadows())
+				renderables.push_back(sceneNode);
+		});
+	}
+
+	void SceneManager::GetVisibleLights(const Collidable &collider, SceneNodes &lights, bool clear) const
+	{
+		if (clear)
+			lights.clear();
+
+		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode)
+		{
+			if (sceneNode->GetComponent<Light>() != nullptr)
+				lights.push_back(sceneNode);
+
+		});
+	}
+
+	void SceneManager::GetVisibleRenderableAndLights(const Collidable &collider, SceneNodes &renderables, SceneNodes &lights, bool clear) const
+	{
+		if (clear)
+		{
+			renderables.clear();
+			lights.clear();
+		}
+
+		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode)
+		{
+			auto render = sceneNode->GetComponent<MeshRender>();
+			if (render != nullptr && render->GetRenderable())
+				renderables.push_back(sceneNode);
+			else if (sceneNode->GetComponent<Light>() != nullptr)
+				lights.push_back(sceneNode);
+
+		});
+	}
+
+	void SceneManager::WalkSceneViews(const std::vector<const Collidable*> &colliders, const ViewFilterFunc &filterFunc, unsigned int categories) const
+	{
+		unsigned int viewCount = std::min((unsigned int)colliders.size(), MAX_VIEW_COUNT);
+
+		SceneNodes sceneNodes;
+		std::vector<uint32_t> viewMasks;
+		std::unordered_map<SceneNode*, unsigned int> indices;
+
+		for (unsigned int view = 0; view < viewCount; view++)
+		{
+			WalkScene(*colliders[view], [&](const SceneNode::Ptr &sceneNode)
+			{
+				auto it = indices.emplace(sceneNode.get(), sceneNodes.size());
+				if (it.second)
+				{
+					sceneNodes.push_back(sceneNode);
+					viewMasks.push_back(0);
+				}
+				viewMasks[it.first->second] |= 1u << view;
+			});
+		}
+
+		for (unsigned int i = 0; i < sceneNodes.size(); i++)
+			filterFunc(sceneNodes[i], viewMasks[i]);
+	}
+
+	bool SceneManager::RayCast(const Ray &ray, RayHit &hit, bool testTriangles, const QueryFilterFunc &filterFunc) const
+	{
+		hit = RayHit();
+
+		// aabb hits near to far, refining stops once the next aabb starts behind the closest hit.
+		std::vector<std::pair<float, SceneNode::Ptr>> candidates;
+		WalkScene(ray, [&](const SceneNode::Ptr &sceneNode)
+		{
+			float near, far;
+			if ((filterFunc == nullptr || filterFunc(sceneNode)) && ray.Intersects(sceneNode->GetWorldAABB(), near, far))
+				candidates.push_back(std::make_pair(near, sceneNode));
+		});
+
+		std::sort(candidates.begin(), candidates.end(), [](const std::pair<float, SceneNode::Ptr> &a, const std::pair<float, SceneNode::Ptr> &b)
+		{
+			return a.first < b.first;
+		});
+
+		float closest = ray.GetMaxDistance();
+		RayHit current;
+
+		for (auto &candidate : candidates)
+		{
+			if (candidate.first > closest)
+				break;
+
+			if (RayCastSceneNode(ray, candidate.second, candidate.first, testTriangles, current) && current.distance <= closest)
+			{
+				closest = current.distance;
+				hit = current;
+			}
+		}
+
+		return hit.sceneNode != nullptr;
+	}
+
+	void SceneManager::RayCastAll(const Ray &ray, std::vector<RayHit> &hits, bool testTriangles, const QueryFilterFunc &filterFunc) const
+	{
+		hits.clear();
+
+		RayHit hit;
+		WalkScene(ray, [&](const SceneNode::Ptr &sceneNode)
+		{
+			if (filterFunc != nullptr && !filterFunc(sceneNode))
+				return;
+
+			float near, far;
+			if (ray.Intersects(sceneNode->GetWorldAABB(), near, far) && RayCastSceneNode(ray, sceneNode, near, testTriangles, hit))
+				hits.push_back(hit);
+		});
+
+		std::sort(hits.begin(), hits.end(), [](const RayHit &a, const RayHit &b)
+		{
+			return a.distance < b.distance;
+		});
+	}
+
+	void SceneManager::QueryNearest(Vector4 point, unsigned int k, SceneNodes &nearest, const QueryFilterFunc &filterFunc, float maxDistance) const
+	{
+		nearest.clear();
+		if (k == 0)
+			return;
+
+		// without a range, every scenenode is a candidate.
+		BoxBounds everything;
+		everything.SetInfinite(true);
+		SphereBounds range(point, maxDistance);
+
+		std::vector<NearestPair> heap;
+		heap.reserve(k);
+
+		auto collect = [&](const SceneNode::Ptr &sceneNode)
+		{
+			if (filterFunc != nullptr && !filterFunc(sceneNode))
+				return;
+
+			float distance = sceneNode->GetWorldAABB().GetDistance(point);
+			if (distance <= maxDistance)
+				PushNearest(heap, k, distance, sceneNode);
+		};
+
+		if (maxDistance < std::numeric_limits<float>::max())
+			WalkScene(range, collect);
+		else
+			WalkScene(everything, collect);
+
+		PopNearest(heap, nearest);
+	}
+
+	void SceneManager::QueryOverlap(const Collidable &collider, SceneNodes &overlaps, const QueryFilterFunc &filterFunc, bool clear) const
+	{
+		if (clear)
+			overlaps.clear();
+
+		WalkScene(collider, [&](const SceneNode::Ptr &sceneNode)
+		{
+			if (filterFunc == nullptr || filterFunc(sceneNode))
+				overlaps.push_back(sceneNode);
+		});
+	}
+
+	void SceneManager::RayCastBatch(const std::vector<Ray> &rays, std::vector<RayHit> &hits, bool testTriangles, const QueryFilterFunc &filterFunc) const
+	{
+		hits.resize(rays.size());
+
+		for (unsigned int i = 0; i < rays.size(); i++)
+			RayCast(rays[i], hits[i], testTriangles, filterFunc);
+	}
+
+	uint64_t SceneManager::GetEpoch() const
+	{
+		return m_Epoch;
+	}
+
+	bool SceneManager::GetChangesSince(uint64_t epoch, std::vector<SceneChange> &changes) const
+	{
+		changes.clear();
+
+		if (epoch < m_ChangeLogEpoch || epoch > m_Epoch)
+			return false;
+
+		changes.assign(m_ChangeLog.begin() + (epoch - m_ChangeLogEpoch), m_ChangeLog.end());
+		return true;
+	}
+
+	void SceneManager::PushNearest(std::vector<NearestPair> &heap, unsigned int k, float distance, const SceneNode::Ptr &sceneNode)
+	{
+		auto nearer = [](const NearestPair &a, const NearestPair &b) { return a.first < b.first; };
+
+		if (heap.size() < k)
+		{
+			heap.push_back(std::make_pair(distance, sceneNode));
+			std::push_heap(heap.begin(), heap.end(), nearer);
+		}
+		else if (distance < heap.front().first)
+		{
+			std::pop_heap(heap.begin(), heap.end(), nearer);
+			heap.back() = std::make_pair(distance, sceneNode);
+			std::push_heap(heap.begin(), heap.end(), nearer);
+		}
+	}
+
+	void SceneManager::PopNearest(std::vector<NearestPair> &heap, SceneNodes &nearest)
+	{
+		std::sort_heap(heap.begin(), heap.end(), [](const NearestPair &a, const NearestPair &b) 
+		{ 
+			return a.first < b.first; 
+		});
+
+		nearest.reserve(nearest.size() + heap.size());
+		for (auto &pair : heap)
+			nearest.push_back(pair.second);
+	}
+
+	bool SceneManager::RayCastSceneNode(const Ray &ray, const SceneNode::Ptr &sceneNode, float aabbDistance, bool testTriangles, RayHit &hit)
+	{
+		TriangleBVH::Ptr triangleBVH;
+		if (testTriangles)
+		{
+			auto render = sceneNode->GetComponent<MeshRender>();
+			auto mesh = render != nullptr ? render->GetMesh() : nullptr;
+			if (mesh != nullptr)
+				triangleBVH = mesh->GetTriangleBVH();
+		}
+
+		// meshes without raw data fall back to their aabbs.
+		if (triangleBVH == nullptr || triangleBVH->GetTriangleCount() == 0)
+		{
+			if (sceneNode->GetWorldAABB().GetInfinite())
+				return false;
+
+			hit.sceneNode = sceneNode;
+			hit.distance = aabbDistance;
+			hit.point = ray.GetPoint(aabbDistance);
+			hit.triangle = -1;
+			return true;
+		}
+
+		Ray localRay = ray.Transform(sceneNode->GetInvertWorldMatrix());
+
+		float distance;
+		unsigned int triangle;
+		if (!triangleBVH->RayCast(localRay, distance, triangle))
+			return false;
+
+		// measure in world space, the world matrix may scale.
+		Vector4 point = sceneNode->GetWorldMatrix().Multiply(localRay.GetPoint(distance));
+
+		hit.sceneNode = sceneNode;
+		hit.distance = (point - ray.GetOrigin()).Length();
+		hit.point = point;
+		hit.triangle = triangle;
+		return hit.distance <= ray.GetMaxDistance();
+	}
+
+	void SceneManager::RecordChange(SceneNode *sceneNode, bool removed)
+	{
+		if (m_ChangeLog.size() >= MAX_CHANGE_LOG)
+		{
+			m_ChangeLog.clear();
+			m_ChangeLogEpoch = m_Epoch;
+		}
+
+		SceneChange change;
+		change.sceneNode = sceneNode;
+		change.removed = removed;
+
+		m_ChangeLog.push_back(change);
+		m_Epoch++;
+	}
+
+	void SceneManager::RecordReset()
+	{
+		m_Epoch++;
+		m_ChangeLog.clear();
+		m_ChangeLogEpoch = m_Epoch;
+	}
+
+	void SceneManager::SetSceneManager(SceneNode &sceneNode, const Ptr &manager)
+	{
+		sceneNode.m_SceneManager = manager;
+	}
+
+	unsigned int SceneManager::GetManagerIndex(const SceneNode &sceneNode)
+	{
+		return sceneNode.m_ManagerIndex;
+	}
+
+	void SceneManager::SetManagerIndex(SceneNode &sceneNode, unsigned int index)
+	{
+		sceneNode.m_ManagerIndex = index;
+	}
+}
\ No newline at end of file
@@ -4,13 +4,18 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <cstdint>
+#include <limits>
 
 #include "Macros.h"
+#include "Fury/Vector4.h"
 
 namespace fury
 {
 	class Collidable;
 
+	class Ray;
+
 	class RenderQuery;
 
 	class SceneNode;
@@ -25,31 +30,144 @@ namespace fury
 
 		typedef std::function<void(const std::shared_ptr<SceneNode>&)> FilterFunc;
 
+		// returns false to skip a scenenode in ray casts and queries.
+		typedef std::function<bool(const std::shared_ptr<SceneNode>&)> QueryFilterFunc;
+
+		// bit i of viewMask is set if the scenenode is visible in the i-th collider of WalkSceneViews.
+		typedef std::function<void(const std::shared_ptr<SceneNode>&, uint32_t viewMask)> ViewFilterFunc;
+
+		struct RayHit
+		{
+			std::shared_ptr<SceneNode> sceneNode;
+
+			float distance = 0.0f;
+
+			Vector4 point;
+
+			// triangle index in the scenenode's mesh, -1 if only the aabb was tested.
+			int triangle = -1;
+		};
+
+		// a scenenode added, moved or removed after some epoch.
+		struct SceneChange
+		{
+			SceneNode *sceneNode;
+
+			bool removed;
+		};
+
+		// changes older than this are dropped, readers fall back to a full query.
+		static const unsigned int MAX_CHANGE_LOG;
+
+		// colliders after this are ignored by WalkSceneViews.
+		static const unsigned int MAX_VIEW_COUNT;
+
+	protected:
+
+		// increased by every change.
+		uint64_t m_Epoch = 0;
+
+		// epoch before the first change in m_ChangeLog.
+		uint64_t m_ChangeLogEpoch = 0;
+
+		std::vector<SceneChange> m_ChangeLog;
+
 	public:
 
+		virtual ~SceneManager() {}
+
 		virtual void AddSceneNode(const std::shared_ptr<SceneNode> &sceneNode) = 0;
 
-		virtual void AddSceneNodeRecursively(const std::shared_ptr<SceneNode> &sceneNode) = 0;
+		virtual void AddSceneNodeRecursively(const std::shared_ptr<SceneNode> &sceneNode);
 
 		virtual void RemoveSceneNode(const std::shared_ptr<SceneNode> &sceneNode) = 0;
 
 		virtual void UpdateSceneNode(const std::shared_ptr<SceneNode> &sceneNode) = 0;
 
-		virtual void GetRenderQuery(const Collidable &collider, const std::shared_ptr<RenderQuery> &renderQuery, bool clear = true) const = 0;
+		// UpdateSceneNode for each of sceneNodes, TransformSystem::Update hands over a frame's moved scenenodes at once.
+		virtual void UpdateSceneNodes(const SceneNodes &sceneNodes);
+
+		// applies work some managers defer after changes, ie. repacking or refitting, so queries never modify them.
+		// until then their queries test every scenenode, Scene::FlushTransforms calls this once per frame.
+		virtual void Flush();
+
+		virtual void GetRenderQuery(const Collidable &collider, const std::shared_ptr<RenderQuery> &renderQuery, bool clear = true) const;
 
-		virtual void GetVisibleSceneNodes(const Collidable &collider, SceneNodes &visibleNodes, bool clear = true) const = 0;
+		virtual void GetVisibleSceneNodes(const Collidable &collider, SceneNodes &visibleNodes, bool clear = true) const;
 
-		virtual void GetVisibleRenderables(const Collidable &collider, SceneNodes &renderables, bool clear = true) const = 0;
+		virtual void GetVisibleRenderables(const Collidable &collider, SceneNodes &renderables, bool clear = true) const;
 
-		virtual void GetVisibleShadowCasters(const Collidable &collider, SceneNodes &renderables, bool clear = true) const = 0;
+		virtual void GetVisibleShadowCasters(const Collidable &collider, SceneNodes &renderables, bool clear = true) const;
 
-		virtual void GetVisibleLights(const Collidable &collider, SceneNodes &lights, bool clear = true) const = 0;
+		virtual void GetVisibleLights(const Collidable &collider, SceneNodes &lights, bool clear = true) const;
 
-		virtual void GetVisibleRenderableAndLights(const Collidable &collider, SceneNodes &renderables, SceneNodes &lights, bool clear = true) const = 0;
+		virtual void GetVisibleRenderableAndLights(const Collidable &collider, SceneNodes &renderables, SceneNodes &lights, bool clear = true) const;
 
+		// the queries above are implemented on top of WalkScene by default.
 		virtual void WalkScene(const Collidable &collider, const FilterFunc &filterFunc) const = 0;
 
+		// WalkScene for several colliders at once, ie. a camera and it's shadow cascades.
+		// filterFunc is called once for each scenenode visible in any of colliders.
+		// categories is a mask of SceneNodeCategory, managers that count categories skip scenenodes in none of them.
+		// the default walks each collider and merges the results.
+		virtual void WalkSceneViews(const std::vector<const Collidable*> &colliders, const ViewFilterFunc &filterFunc, unsigned int categories = 0) const;
+
 		virtual void Clear() = 0;
+
+		// nearest scenenode hit by ray, within ray's max distance.
+		// with testTriangles, hits on scenenodes with a MeshRender are refined against the mesh's triangles.
+		virtual bool RayCast(const Ray &ray, RayHit &hit, bool testTriangles = false, const QueryFilterFunc &filterFunc = nullptr) const;
+
+		// every hit, sorted near to far.
+		virtual void RayCastAll(const Ray &ray, std::vector<RayHit> &hits, bool testTriangles = false, const QueryFilterFunc &filterFunc = nullptr) const;
+
+		// k scenenodes with world aabbs nearest to point, sorted near to far.
+		// scenenodes farther than maxDistance are ignored.
+		virtual void QueryNearest(Vector4 point, unsigned int k, SceneNodes &nearest, const QueryFilterFunc &filterFunc = nullptr, 
+			float maxDistance = std::numeric_limits<float>::max()) const;
+
+		// scenenodes overlapping collider that pass filterFunc, in no particular order.
+		virtual void QueryOverlap(const Collidable &collider, SceneNodes &overlaps, const QueryFilterFunc &filterFunc = nullptr, bool clear = true) const;
+
+		// RayCast for each ray, hits[i].sceneNode is nullptr if rays[i] hits nothing.
+		// managers that can be queried concurrently spread rays on ThreadUtil's workers, filterFunc must be thread safe then.
+		virtual void RayCastBatch(const std::vector<Ray> &rays, std::vector<RayHit> &hits, bool testTriangles = false, const QueryFilterFunc &filterFunc = nullptr) const;
+
+		uint64_t GetEpoch() const;
+
+		// fills changes made after epoch, in order. 
+		// returns false if the log doesn't reach back that far.
+		bool GetChangesSince(uint64_t epoch, std::vector<SceneChange> &changes) const;
+
+	protected:
+
+		typedef std::pair<float, std::shared_ptr<SceneNode>> NearestPair;
+
+		// keeps the k nearest pairs in a max heap on distance, farthest at front.
+		static void PushNearest(std::vector<NearestPair> &heap, unsigned int k, float distance, const std::shared_ptr<SceneNode> &sceneNode);
+
+		// sorts heap near to far into nearest.
+		static void PopNearest(std::vector<NearestPair> &heap, SceneNodes &nearest);
+
+		// aabbDistance is where ray enters sceneNode's world aabb.
+		// returns false if ray misses the mesh, or sceneNode has an infinite aabb and no mesh to test.
+		static bool RayCastSceneNode(const Ray &ray, const std::shared_ptr<SceneNode> &sceneNode, float aabbDistance, bool testTriangles, RayHit &hit);
+
+		// implementations call these on insert/update/remove, so caches built on queries can be patched.
+		void RecordChange(SceneNode *sceneNode, bool removed);
+
+		// drops the log, for changes that can't be listed. ie, Clear().
+		void RecordReset();
+
+		// managers other than OcTree register themselves to attached scenenodes through this, 
+		// so SceneNode::Recompose and SceneNode::RemoveFromOcTree can reach them.
+		static void SetSceneManager(SceneNode &sceneNode, const Ptr &manager);
+
+		// a slot on the scenenode for the manager it's attached to, so finding it's entry doesn't need a hash lookup.
+		// other managers may have left a stale value, check it against your own entries.
+		static unsigned int GetManagerIndex(const SceneNode &sceneNode);
+
+		static void SetManagerIndex(SceneNode &sceneNode, unsigned int index);
 	};
 }
 
@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
 #include "Fury/MathUtil.h"
 #include "Fury/Component.h"
+#include "Fury/ComponentStore.h"
 #include "Fury/Log.h"
 #include "Fury/Light.h"
 #include "Fury/OcTreeNode.h"
@@ -10,13 +15,26 @@
 #include "Fury/MeshRender.h"
 #include "Fury/Mesh.h"
 #include "Fury/Material.h"
+#include "Fury/Prefab.h"
+#include "Fury/SceneNodeIndex.h"
+#include "Fury/TransformSystem.h"
 
 namespace fury
 {
-	std::unordered_map<std::string, std::function<Component::Ptr()>> SceneNode::ComponentRegistry = 
+	// type ids below this are flagged in m_ComponentMask.
+	static const unsigned int MASKED_TYPE_COUNT = 32;
+
+	static unsigned int CountBits(uint32_t bits)
+	{
+		bits = bits - ((bits >> 1) & 0x55555555u);
+		bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+		return (((bits + (bits >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+	}
+
+	std::unordered_map<std::string, SceneNode::ComponentEntry> SceneNode::ComponentRegistry = 
 	{
-		{ "MeshRender", []() -> Component::Ptr { return MeshRender::Create(nullptr, nullptr); } },
-		{ "Light", []() -> Component::Ptr { return Light::Create(); } }
+		{ "MeshRender", { Component::GetTypeId<MeshRender>(), []() -> Component::Ptr { return MeshRender::Create(nullptr, nullptr); } } },
+		{ "Light", { Component::GetTypeId<Light>(), []() -> Component::Ptr { return Light::Create(); } } }
 	};
 
 	SceneNode::Ptr SceneNode::Create(const std::string &name)
@@ -25,16 +43,27 @@ namespace fury
 	}
 
 	SceneNode::SceneNode(const std::string &name)
-		: Entity(name), m_LocalScale(1.0f, 1.0f, 1.0f, 1.0f), m_TransformDirty(true)
+		: Entity(name)
 	{
 		m_TypeIndex = typeid(SceneNode);
-		OnTransformChange = Signal<const Ptr&>::Create();
+
+		if (TransformSystem::Active == nullptr)
+			TransformSystem::Active = TransformSystem::Create();
+
+		m_TransformSystem = TransformSystem::Active;
+		m_TransformHandle = m_TransformSystem->Add(this);
+
+		if (ComponentStore::Active == nullptr)
+			ComponentStore::Active = ComponentStore::Create();
+
+		m_ComponentStore = ComponentStore::Active;
 	}
 
 	SceneNode::~SceneNode()
 	{
 		RemoveAllComponents(true);
 		RemoveAllChilds();
+		m_TransformSystem->Remove(m_TransformHandle);
 		//FURYD << m_Name << " destoried.";
 	}
 
@@ -55,34 +84,89 @@ namespace fury
 		if (!Entity::Load(wrapper, false))
 			return false;
 
+		// prefab instance, components below override the prefab's
+		std::string prefabName;
+		if (LoadMemberValue(wrapper, "prefab", prefabName))
+		{
+			auto prefab = Scene::Manager()->Get<Prefab>(prefabName);
+			if (prefab == nullptr)
+			{
+				FURYE << "Prefab " << prefabName << " not found!";
+				return false;
+			}
+
+			// changes below the instance root, by path hash relative to it.
+			Prefab::Overrides overrides;
+			auto overridesWrapper = FindMember(wrapper, "overrides");
+			if (overridesWrapper != nullptr && !LoadArray(overridesWrapper, [&](const void* node) -> bool
+			{
+				std::string path;
+				if (!LoadMemberValue(node, "path", path))
+				{
+					FURYE << "path not found!";
+					return false;
+				}
+
+				unsigned int index = 0;
+				LoadMemberValue(node, "index", index);
+
+				auto &wrappers = overrides[(size_t)std::strtoull(path.c_str(), nullptr, 10)];
+				if (wrappers.size() <= index)
+					wrappers.resize(index + 1, nullptr);
+
+				wrappers[index] = node;
+				return true;
+			}))
+			{
+				return false;
+			}
+
+			prefab->Instantiate(shared_from_this(), overrides);
+		}
+
 		// local translation
-		if (!LoadMemberValue(wrapper, "pos", m_LocalPosition))
+		Vector4 position, scale;
+		Quaternion rotation;
+
+		if (!LoadMemberValue(wrapper, "pos", position))
 		{
 			FURYE << "pos not found!";
 			return false;
 		}
 
-		if (!LoadMemberValue(wrapper, "scl", m_LocalScale))
+		if (!LoadMemberValue(wrapper, "scl", scale))
 		{
 			FURYE << "scl not found!";
 			return false;
 		}
 
-		if (!LoadMemberValue(wrapper, "rot", m_LocalRotation))
+		if (!LoadMemberValue(wrapper, "rot", rotation))
 		{
 			FURYE << "rot not found!";
 			return false;
 		}
 
+		m_TransformSystem->SetLocalPosition(m_TransformHandle, position);
+		m_TransformSystem->SetLocalScale(m_TransformHandle, scale);
+		m_TransformSystem->SetLocalRotation(m_TransformHandle, rotation);
+
 		// model aabb
 		LoadMemberValue(wrapper, "aabb", m_ModelAABB);
 
-		// apply transforms
-		Recompose(true);
+		// baked by the flush after loading
+		bool isStatic = false;
+		if (LoadMemberValue(wrapper, "static", isStatic))
+			SetStatic(isStatic);
+
+		// transforms are applied by the next flush, after childs are attached.
+
+		return LoadComponents(wrapper) && LoadChilds(wrapper);
+	}
 
-		// load components
+	bool SceneNode::LoadComponents(const void* wrapper)
+	{
 		std::string type;
-		if (!LoadArray(wrapper, "components", [&](const void* node) -> bool
+		return LoadArray(wrapper, "components", [&](const void* node) -> bool
 		{
 			if (!IsObject(node))
 			{
@@ -103,9 +187,12 @@ namespace fury
 				return true;
 			}
 
-			auto component = it->second();
+			auto component = it->second.create();
 			if (component->Load(node))
 			{
+				if (m_Prefab != nullptr || m_PrefabChild)
+					RemoveComponent(it->second.typeId);
+
 				AddComponent(component);
 				return true;
 			}
@@ -113,13 +200,12 @@ namespace fury
 			{
 				return false;
 			}
-		}))
-		{
-			return false;
-		}
+		});
+	}
 
-		// load childs
-		if (!LoadArray(wrapper, "childs", [&](const void* node) -> bool
+	bool SceneNode::LoadChilds(const void* wrapper)
+	{
+		return LoadArray(wrapper, "childs", [&](const void* node) -> bool
 		{
 			auto child = SceneNode::Create("temp");
 			if (child->Load(node))
@@ -131,12 +217,25 @@ namespace fury
 			{
 				return false;
 			}
-		}))
-		{
-			return false;
-		}
-		
-		return true;
+		});
+	}
+
+	bool SceneNode::LoadPrefabOverride(const void* wrapper)
+	{
+		// transforms are only saved if they differ from the prefab's.
+		Vector4 position, scale;
+		Quaternion rotation;
+
+		if (LoadMemberValue(wrapper, "pos", position))
+			m_TransformSystem->SetLocalPosition(m_TransformHandle, position);
+
+		if (LoadMemberValue(wrapper, "scl", scale))
+			m_TransformSystem->SetLocalScale(m_TransformHandle, scale);
+
+		if (LoadMemberValue(wrapper, "rot", rotation))
+			m_TransformSystem->SetLocalRotation(m_TransformHandle, rotation);
+
+		return LoadComponents(wrapper) && LoadChilds(wrapper);
 	}
 
 	void SceneNode::Save(void* wrapper, bool object)
@@ -147,43 +246,180 @@ namespace fury
 		Entity::Save(wrapper, false);
 
 		SaveKey(wrapper, "pos");
-		SaveValue(wrapper, m_LocalPosition);
+		SaveValue(wrapper, GetLocalPosition());
 
 		SaveKey(wrapper, "rot");
-		SaveValue(wrapper, m_LocalRotation);
+		SaveValue(wrapper, GetLocalRoattion());
 
 		SaveKey(wrapper, "scl");
-		SaveValue(wrapper, m_LocalScale);
+		SaveValue(wrapper, GetLocalScale());
 
 		SaveKey(wrapper, "aabb");
 		SaveValue(wrapper, m_ModelAABB);
 
+		if (GetStatic())
+		{
+			SaveKey(wrapper, "static");
+			SaveValue(wrapper, true);
+		}
+
+		// instances only save what differs from their prefab.
+		if (m_Prefab != nullptr)
+		{
+			SaveKey(wrapper, "prefab");
+			SaveValue(wrapper, m_Prefab->GetName());
+		}
+
+		SaveComponents(wrapper);
+		SaveChilds(wrapper);
+
+		if (m_Prefab != nullptr && m_Prefab->GetSource() != nullptr)
+		{
+			std::unordered_map<size_t, unsigned int> counts;
+
+			SaveKey(wrapper, "overrides");
+			StartArray(wrapper);
+			SavePrefabOverrides(wrapper, m_Prefab->GetSource().get(), 0, counts);
+			EndArray(wrapper);
+		}
+
+		if (object)
+			EndObject(wrapper);
+	}
+
+	void SceneNode::SaveComponents(void* wrapper)
+	{
 		SaveKey(wrapper, "components");
 		StartArray(wrapper);
-		for (auto pair : m_Components)
-			pair.second->Save(wrapper);
+		for (auto &slot : m_Components)
+		{
+			if (!slot.shared)
+				m_ComponentStore->Get(slot.typeId, slot.handle)->Save(wrapper);
+		}
 		EndArray(wrapper);
+	}
 
+	void SceneNode::SaveChilds(void* wrapper)
+	{
 		SaveKey(wrapper, "childs");
-		SaveArray(wrapper, m_Childs.size(), [&](unsigned int index)
+		StartArray(wrapper);
+		for (auto &child : m_Childs)
 		{
-			m_Childs[index]->Save(wrapper);
-		});
+			if (!child->m_PrefabChild)
+				child->Save(wrapper);
+		}
+		EndArray(wrapper);
+	}
 
-		if (object)
-			EndObject(wrapper);
+	void SceneNode::SavePrefabOverrides(void* wrapper, const SceneNode *source, size_t pathHash, std::unordered_map<size_t, unsigned int> &counts)
+	{
+		// prefab childs were built in source's child order, some may have been removed since.
+		unsigned int sourceIndex = 0;
+		for (auto &child : m_Childs)
+		{
+			if (!child->m_PrefabChild)
+				continue;
+
+			const SceneNode *sourceChild = nullptr;
+			for (unsigned int i = sourceIndex; source != nullptr && i < source->m_Childs.size(); i++)
+			{
+				if (source->m_Childs[i]->GetHashCode() == child->GetHashCode())
+				{
+					sourceChild = source->m_Childs[i].get();
+					sourceIndex = i + 1;
+					break;
+				}
+			}
+
+			// Prefab::InstantiateNode counts in the same depth first order.
+			size_t childPath = SceneNodeIndex::CombinePath(pathHash, child->GetHashCode());
+			unsigned int index = counts[childPath]++;
+
+			bool moved = sourceChild == nullptr || child->GetLocalPosition() != sourceChild->GetLocalPosition() ||
+				child->GetLocalRoattion() != sourceChild->GetLocalRoattion() || child->GetLocalScale() != sourceChild->GetLocalScale();
+
+			bool changed = moved;
+			for (auto &slot : child->m_Components)
+				changed = changed || !slot.shared;
+			for (auto &grandChild : child->m_Childs)
+				changed = changed || !grandChild->m_PrefabChild;
+
+			if (changed)
+			{
+				StartObject(wrapper);
+
+				SaveKey(wrapper, "path");
+				SaveValue(wrapper, std::to_string(childPath));
+
+				if (index > 0)
+				{
+					SaveKey(wrapper, "index");
+					SaveValue(wrapper, index);
+				}
+
+				if (moved)
+				{
+					SaveKey(wrapper, "pos");
+					SaveValue(wrapper, child->GetLocalPosition());
+
+					SaveKey(wrapper, "rot");
+					SaveValue(wrapper, child->GetLocalRoattion());
+
+					SaveKey(wrapper, "scl");
+					SaveValue(wrapper, child->GetLocalScale());
+				}
+
+				child->SaveComponents(wrapper);
+				child->SaveChilds(wrapper);
+
+				EndObject(wrapper);
+			}
+
+			child->SavePrefabOverrides(wrapper, sourceChild, childPath, counts);
+		}
+	}
+
+	size_t SceneNode::SetName(const std::string &name)
+	{
+		// path hashes of descendants include this name, the root's doesn't.
+		auto index = m_Parent.expired() ? nullptr : m_NodeIndex;
+		if (index != nullptr)
+			SetNodeIndex(nullptr);
+
+		Entity::SetName(name);
+
+		if (index != nullptr)
+			SetNodeIndex(index);
+
+		return m_HashCode;
 	}
 
 	SceneNode::Ptr SceneNode::Clone(const std::string &name) const
 	{
 		auto ptr = SceneNode::Create(name);
 		// clone components
-		for (auto &comp : m_Components)
-			ptr->AddComponent(comp.second->Clone());
+		if (m_Prefab != nullptr)
+		{
+			// another instance, with clones of components this one made unique.
+			m_Prefab->Instantiate(ptr);
+			for (auto &slot : m_Components)
+			{
+				if (!slot.shared)
+				{
+					ptr->RemoveComponent(slot.typeId);
+					ptr->AddComponent(m_ComponentStore->Get(slot.typeId, slot.handle)->Clone());
+				}
+			}
+		}
+		else
+		{
+			for (auto &slot : m_Components)
+				ptr->AddComponent(m_ComponentStore->Get(slot.typeId, slot.handle)->Clone());
+		}
 		// clone translations
-		ptr->SetLocalPosition(m_LocalPosition);
-		ptr->SetLocalRoattion(m_LocalRotation);
-		ptr->SetLocalScale(m_LocalScale);
+		ptr->SetLocalPosition(GetLocalPosition());
+		ptr->SetLocalRoattion(GetLocalRoattion());
+		ptr->SetLocalScale(GetLocalScale());
 		return ptr;
 	}
 
@@ -192,10 +428,17 @@ namespace fury
 		m_OcTreeNode = ocTreeNode;
 	}
 
+	std::shared_ptr<OcTreeNode> SceneNode::GetOcTreeNode() const
+	{
+		return m_OcTreeNode.lock();
+	}
+
 	void SceneNode::RemoveFromOcTree(bool recursively)
 	{
 		if (!m_OcTreeNode.expired())
 			m_OcTreeNode.lock()->RemoveSceneNode(shared_from_this());
+		else if (auto manager = m_SceneManager.lock())
+			manager->RemoveSceneNode(shared_from_this());
 
 		if (recursively)
 		{
@@ -206,16 +449,11 @@ namespace fury
 
 	void SceneNode::SetModelAABB(const BoxBounds &aabb)
 	{
-		if (aabb.GetInfinite())
-		{
-			m_ModelAABB = m_LocalAABB = m_WorldAABB = aabb;
-		}
-		else
-		{
-			m_ModelAABB = aabb;
-			m_LocalAABB = m_LocalMatrix.Multiply(m_ModelAABB);
-			m_WorldAABB = m_WorldMatrix.Multiply(m_ModelAABB);
-		}
+		m_ModelAABB = aabb;
+		UpdateAABB();
+
+		// scene managers cache world aabbs for culling.
+		UpdateSceneManager();
 	}
 
 	BoxBounds SceneNode::GetModelAABB() const
@@ -239,109 +477,85 @@ namespace fury
 
 	void SceneNode::Recompose(bool force)
 	{
-		if (!force && !m_TransformDirty)
+		// baked transforms don't follow their parents, so neither do their childs.
+		if (m_TransformSystem->GetFrozen(m_TransformHandle))
 			return;
 
-		m_TransformDirty = false;
-
-		// update local matrix
-		m_LocalMatrix.Identity();
-		m_LocalMatrix.AppendTranslation(m_LocalPosition);
-		m_LocalMatrix.AppendRotation(m_LocalRotation);
-		m_LocalMatrix.AppendScale(m_LocalScale);
-
-		m_InvertLocalMatrix = m_LocalMatrix.Inverse();
+		if (!force && !m_TransformSystem->GetDirty(m_TransformHandle))
+			return;
 
-		// update world matrix
-		if (m_Parent.expired())
-		{
-			m_WorldMatrix = m_LocalMatrix;
-			m_WorldPosition = m_LocalPosition;
-			m_WorldRotation = m_LocalRotation;
-			m_WorldScale = m_LocalScale;
-		}
-		else
-		{
-			Matrix4 matrix = m_Parent.lock()->GetWorldMatrix();
-			m_WorldMatrix = matrix * m_LocalMatrix;
-			m_WorldPosition = matrix.Multiply(m_LocalPosition);
-			m_WorldRotation = matrix.Multiply(m_LocalRotation);
-			m_WorldScale = matrix.Multiply(m_LocalScale);
-		}
-		m_InvertWorldMatrix = m_WorldMatrix.Inverse();
+		m_TransformSystem->Compose(m_TransformHandle);
 
 		// update bounding box
-		SetModelAABB(m_ModelAABB);
+		UpdateAABB();
 
-		// update octree info
-		if (!m_OcTreeNode.expired())
-			m_OcTreeNode.lock()->GetManager().UpdateSceneNode(shared_from_this());
-
-		// trigger event
-		OnTransformChange->Emit(shared_from_this());
+		// update octree info and trigger event
+		NotifyTransformChange();
 
 		// force update child nodes' matrix
 		for (auto &child : m_Childs)
 			child->Recompose(true);
 	}
 
+	std::shared_ptr<TransformSystem> SceneNode::GetTransformSystem() const
+	{
+		return m_TransformSystem;
+	}
+
 	Matrix4 SceneNode::GetLocalMatrix() const
 	{
-		return m_LocalMatrix;
+		return m_TransformSystem->GetLocalMatrix(m_TransformHandle);
 	}
 
 	Matrix4 SceneNode::GetInvertLocalMatrix() const
 	{
-		return m_InvertLocalMatrix;
+		return m_TransformSystem->GetInvertLocalMatrix(m_TransformHandle);
 	}
 
 	Matrix4 SceneNode::GetWorldMatrix() const
 	{
-		return m_WorldMatrix;
+		return m_TransformSystem->GetWorldMatrix(m_TransformHandle);
 	}
 
 	Matrix4 SceneNode::GetInvertWorldMatrix() const
 	{
-		return m_InvertWorldMatrix;
+		return m_TransformSystem->GetInvertWorldMatrix(m_TransformHandle);
 	}
 
 	Vector4 SceneNode::GetWorldPosition() const
 	{
-		return m_WorldPosition;
+		return m_TransformSystem->GetWorldPosition(m_TransformHandle);
 	}
 
 	Quaternion SceneNode::GetWorldRoattion() const
 	{
-		return m_WorldRotation;
+		return m_TransformSystem->GetWorldRotation(m_TransformHandle);
 	}
 
 	Vector4 SceneNode::GetWorldScale() const
 	{
-		return m_WorldScale;
+		return m_TransformSystem->GetWorldScale(m_TransformHandle);
 	}
 
 	Vector4 SceneNode::GetLocalPosition() const
 	{
-		return m_LocalPosition;
+		return m_TransformSystem->GetLocalPosition(m_TransformHandle);
 	}
 
 	Quaternion SceneNode::GetLocalRoattion() const
 	{
-		return m_LocalRotation;
+		return m_TransformSystem->GetLocalRotation(m_TransformHandle);
 	}
 
 	Vector4 SceneNode::GetLocalScale() const
 	{
-		return m_LocalScale;
+		return m_TransformSystem->GetLocalScale(m_TransformHandle);
 	}
 
 	void SceneNode::SetLocalPosition(Vector4 position)
 	{
-		if (m_TransformDirty || m_LocalPosition != position)
-		{
-			m_LocalPosition = position;
-			m_TransformDirty = true;
-		}
+		if (m_TransformSystem->GetDirty(m_TransformHandle) || GetLocalPosition() != position)
+			m_TransformSystem->SetLocalPosition(m_TransformHandle, position);
 	}
 
 	void SceneNode::SetLocalPosition(float x, float y, float z)
@@ -351,11 +565,8 @@ namespace fury
 
 	void SceneNode::SetLocalRoattion(Quaternion rotation)
 	{
-		if (m_TransformDirty || m_LocalRotation != rotation)
-		{
-			m_LocalRotation = rotation;
-			m_TransformDirty = true;
-		}
+		if (m_TransformSystem->GetDirty(m_TransformHandle) || GetLocalRoattion() != rotation)
+			m_TransformSystem->SetLocalRotation(m_TransformHandle, rotation);
 	}
 
 	void SceneNode::SetLocalRoattion(float x, float y, float z)
@@ -371,11 +582,8 @@ namespace fury
 
 	void SceneNode::SetLocalScale(Vector4 scale)
 	{
-		if (m_TransformDirty || m_LocalScale != scale)
-		{
-			m_LocalScale = scale;
-			m_TransformDirty = true;
-		}
+		if (m_TransformSystem->GetDirty(m_TransformHandle) || GetLocalScale() != scale)
+			m_TransformSystem->SetLocalScale(m_TransformHandle, scale);
 	}
 
 	void SceneNode::SetLocalScale(float factor)
@@ -390,7 +598,57 @@ namespace fury
 	void SceneNode::SetParent(const SceneNode::Ptr &parent)
 	{
 		m_Parent = parent;
-		Recompose(true);
+		m_TransformSystem->SetParent(m_TransformHandle, parent != nullptr ? parent->m_TransformHandle : TransformSystem::INVALID_HANDLE);
+
+		// world transform follows the new parent at the next flush or Recompose.
+		m_TransformSystem->SetDirty(m_TransformHandle);
+
+		// leave the old scene's index, or join the new one with new path hashes.
+		auto index = parent != nullptr ? parent->m_NodeIndex : nullptr;
+		if (index != nullptr || m_NodeIndex != nullptr)
+			SetNodeIndex(index);
+
+		// components follow into the parent's store, so each scene only walks it's own.
+		auto store = parent != nullptr ? parent->m_ComponentStore : ComponentStore::Active;
+		if (store != m_ComponentStore)
+			SetComponentStore(store);
+	}
+
+	void SceneNode::SetNodeIndex(const std::shared_ptr<SceneNodeIndex> &index)
+	{
+		if (m_NodeIndex != nullptr)
+			m_NodeIndex->Remove(this);
+
+		m_NodeIndex = index;
+		if (m_NodeIndex != nullptr)
+		{
+			auto parent = m_Parent.lock();
+			m_PathHash = SceneNodeIndex::CombinePath(parent != nullptr ? parent->m_PathHash : 0, m_HashCode);
+			m_NodeIndex->Add(this);
+		}
+		else
+		{
+			m_PathHash = 0;
+		}
+
+		for (auto &child : m_Childs)
+			child->SetNodeIndex(index);
+	}
+
+	void SceneNode::SetComponentStore(const std::shared_ptr<ComponentStore> &store)
+	{
+		// slots keep their order, only handles change.
+		for (auto &slot : m_Components)
+		{
+			Component::Ptr component = m_ComponentStore->Get(slot.typeId, slot.handle);
+			m_ComponentStore->Remove(slot.typeId, slot.handle);
+			slot.handle = store->Add(slot.typeId, component, this);
+		}
+
+		m_ComponentStore = store;
+
+		for (auto &child : m_Childs)
+			child->SetComponentStore(store);
 	}
 
 	SceneNode::Ptr SceneNode::GetParent() const
@@ -507,6 +765,15 @@ namespace fury
 
 	SceneNode::Ptr SceneNode::FindChildRecursively(size_t hashcode) const
 	{
+		if (m_NodeIndex != nullptr)
+		{
+			// only a scene's root node is indexed without a parent, all indexed nodes are below it.
+			if (m_Parent.expired())
+				return m_NodeIndex->Find(hashcode);
+			else
+				return m_NodeIndex->Find(hashcode, this);
+		}
+
 		std::vector<Ptr> nodeWithChilds;
 		unsigned int childCount = m_Childs.size();
 		unsigned int i, j;
@@ -544,11 +811,64 @@ namespace fury
 		return nullptr;
 	}
 
+	SceneNode::Ptr SceneNode::FindChildByPath(const std::string &path) const
+	{
+		size_t pathHash = m_PathHash;
+		unsigned int depth = 0;
+
+		// without an index, resolve one child per name.
+		Ptr node = nullptr;
+
+		size_t start = 0;
+		while (start <= path.size())
+		{
+			size_t end = path.find('/', start);
+			if (end == std::string::npos)
+				end = path.size();
+
+			if (end > start)
+			{
+				size_t hashcode = std::hash<std::string>()(path.substr(start, end - start));
+				if (m_NodeIndex != nullptr)
+				{
+					pathHash = SceneNodeIndex::CombinePath(pathHash, hashcode);
+					depth++;
+				}
+				else
+				{
+					node = node != nullptr ? node->FindChild(hashcode) : FindChild(hashcode);
+					if (node == nullptr)
+						return nullptr;
+				}
+			}
+
+			start = end + 1;
+		}
+
+		if (m_NodeIndex == nullptr || depth == 0)
+			return node;
+
+		if (m_Parent.expired())
+			return m_NodeIndex->FindPath(pathHash);
+		else
+			return m_NodeIndex->FindPath(pathHash, this, depth);
+	}
+
 	unsigned int SceneNode::GetChildCount() const
 	{
 		return m_Childs.size();
 	}
 
+	std::shared_ptr<SceneNodeIndex> SceneNode::GetNodeIndex() const
+	{
+		return m_NodeIndex;
+	}
+
+	size_t SceneNode::GetPathHash() const
+	{
+		return m_PathHash;
+	}
+
 	SceneNode::Ptr SceneNode::GetChildAt(unsigned int index) const
 	{
 		if(index < m_Childs.size())
@@ -571,26 +891,102 @@ namespace fury
 		if (ptr->HasOwner())
 			return false;
 
-		auto it = m_Components.emplace(ptr->GetTypeIndex(), ptr);
-		if (it.second)
+		unsigned int typeId = Component::GetTypeId(ptr->GetTypeIndex());
+
+		auto it = std::lower_bound(m_Components.begin(), m_Components.end(), typeId, 
+			[](const ComponentSlot &slot, unsigned int id)
 		{
-			ptr->OnAttaching(shared_from_this());
-			return true;
-		}
-		return false;
+			return slot.typeId < id;
+		});
+
+		if (it != m_Components.end() && it->typeId == typeId)
+			return false;
+
+		m_Components.insert(it, { typeId, m_ComponentStore->Add(typeId, ptr, this), false });
+		if (typeId < MASKED_TYPE_COUNT)
+			m_ComponentMask |= 1u << typeId;
+
+		ptr->OnAttaching(shared_from_this());
+		UpdateCategories();
+		return true;
+	}
+
+	void SceneNode::AddSharedComponent(unsigned int typeId, const std::shared_ptr<Component> &ptr)
+	{
+		auto it = std::lower_bound(m_Components.begin(), m_Components.end(), typeId, 
+			[](const ComponentSlot &slot, unsigned int id)
+		{
+			return slot.typeId < id;
+		});
+
+		if (it != m_Components.end() && it->typeId == typeId)
+			return;
+
+		// ptr stays owned by the prefab's source, so it's not attached, only told it's shared.
+		m_Components.insert(it, { typeId, m_ComponentStore->Add(typeId, ptr, this), true });
+		if (typeId < MASKED_TYPE_COUNT)
+			m_ComponentMask |= 1u << typeId;
+
+		ptr->OnSharing(shared_from_this());
+		UpdateCategories();
+	}
+
+	std::shared_ptr<Component> SceneNode::MakeComponentUnique(unsigned int typeId)
+	{
+		auto it = FindComponentSlot(typeId);
+		if (it == m_Components.end())
+			return nullptr;
+
+		if (!it->shared)
+			return m_ComponentStore->Get(typeId, it->handle);
+
+		// keep the slot's position and mask bit, only the component changes.
+		auto shared = m_ComponentStore->Get(typeId, it->handle);
+		auto clone = shared->Clone();
+		shared->OnUnsharing(*this);
+		m_ComponentStore->Remove(typeId, it->handle);
+		it->handle = m_ComponentStore->Add(typeId, clone, this);
+		it->shared = false;
+
+		clone->OnAttaching(shared_from_this());
+		UpdateCategories();
+		return clone;
+	}
+
+	std::vector<SceneNode::ComponentSlot>::iterator SceneNode::FindComponentSlot(unsigned int typeId)
+	{
+		return std::find_if(m_Components.begin(), m_Components.end(), 
+			[typeId](const ComponentSlot &slot)
+		{
+			return slot.typeId == typeId;
+		});
 	}
 
 	bool SceneNode::RemoveComponent(std::type_index type)
 	{
-		auto it = m_Components.find(type);
-		Component::Ptr ptr = nullptr;
+		return RemoveComponent(Component::GetTypeId(type));
+	}
 
+	bool SceneNode::RemoveComponent(unsigned int typeId)
+	{
+		auto it = FindComponentSlot(typeId);
 		if (it != m_Components.end())
 		{
-			ptr = it->second;
+			Component::Ptr ptr = m_ComponentStore->Get(typeId, it->handle);
+			bool shared = it->shared;
+
+			m_ComponentStore->Remove(typeId, it->handle);
 			m_Components.erase(it);
+			if (typeId < MASKED_TYPE_COUNT)
+				m_ComponentMask &= ~(1u << typeId);
+
+			// shared components were never attached to this node.
+			if (shared)
+				ptr->OnUnsharing(*this);
+			else
+				ptr->OnDetaching(shared_from_this());
 
-			ptr->OnDetaching(shared_from_this());
+			UpdateCategories();
 			return true;
 		}
 
@@ -599,24 +995,200 @@ namespace fury
 
 	std::shared_ptr<Component> SceneNode::GetComponent(std::type_index type) const
 	{
-		auto it = m_Components.find(type);
+		return GetComponent(Component::GetTypeId(type));
+	}
 
-		if (it != m_Components.end())
-			return it->second;
+	const std::shared_ptr<Component> &SceneNode::GetComponent(unsigned int typeId) const
+	{
+		static const Component::Ptr none = nullptr;
 
-		return nullptr;
+		if (typeId < MASKED_TYPE_COUNT)
+		{
+			uint32_t bit = 1u << typeId;
+			if ((m_ComponentMask & bit) == 0)
+				return none;
+
+			return m_ComponentStore->Get(typeId, m_Components[CountBits(m_ComponentMask & (bit - 1))].handle);
+		}
+
+		for (unsigned int i = CountBits(m_ComponentMask); i < m_Components.size(); i++)
+		{
+			if (m_Components[i].typeId == typeId)
+				return m_ComponentStore->Get(typeId, m_Components[i].handle);
+		}
+
+		return none;
 	}
 
 	void SceneNode::RemoveAllComponents(bool destructing)
 	{
-		for (auto it : m_Components)
+		// the store may hold the last references, keep components until they're detached.
+		std::vector<Component::Ptr> components;
+		for (auto &slot : m_Components)
+		{
+			// shared components were never attached to this node.
+			if (slot.shared)
+				m_ComponentStore->Get(slot.typeId, slot.handle)->OnUnsharing(*this);
+			else
+				components.push_back(m_ComponentStore->Get(slot.typeId, slot.handle));
+		}
+
+		for (auto &component : components)
 		{
 			if (destructing)
-				it.second->OnOwnerDestructing(*this);
+				component->OnOwnerDestructing(*this);
 			else
-				it.second->OnDetaching(shared_from_this());
+				component->OnDetaching(shared_from_this());
 		}
+
+		for (auto &slot : m_Components)
+			m_ComponentStore->Remove(slot.typeId, slot.handle);
 			
 		m_Components.clear();
+		m_ComponentMask = 0;
+
+		if (!destructing)
+			UpdateCategories();
+	}
+
+	std::shared_ptr<ComponentStore> SceneNode::GetComponentStore() const
+	{
+		return m_ComponentStore;
+	}
+
+	std::shared_ptr<Prefab> SceneNode::GetPrefab() const
+	{
+		return m_Prefab;
+	}
+
+	unsigned int SceneNode::GetCategories() const
+	{
+		unsigned int categories = 0;
+
+		if (GetComponent<Light>() != nullptr)
+			categories |= (unsigned int)SceneNodeCategory::LIGHT;
+
+		if (auto meshRender = GetComponent<MeshRender>())
+		{
+			if (auto mesh = meshRender->GetMesh())
+			{
+				categories |= (unsigned int)SceneNodeCategory::RENDERABLE;
+				if (mesh->GetCastShadows())
+					categories |= (unsigned int)SceneNodeCategory::SHADOW_CASTER;
+			}
+		}
+
+		return categories;
+	}
+
+	void SceneNode::UpdateCategories()
+	{
+		if (auto treeNode = m_OcTreeNode.lock())
+			treeNode->UpdateSceneNodeCategories(shared_from_this());
+	}
+
+	unsigned int SceneNode::GetCurrentLOD(const std::shared_ptr<Camera> &camera) const
+	{
+		for (auto &entry : m_CameraLODs)
+		{
+			if (entry.camera == camera.get() && !entry.cameraPtr.expired())
+				return entry.lod;
+		}
+
+		return 0;
+	}
+
+	void SceneNode::SetCurrentLOD(const std::shared_ptr<Camera> &camera, unsigned int lod)
+	{
+		// entries of destroyed cameras are reused, a new camera may have the same address.
+		CameraLOD *entry = nullptr;
+		for (auto &other : m_CameraLODs)
+		{
+			if (other.cameraPtr.expired())
+			{
+				if (entry == nullptr)
+					entry = &other;
+			}
+			else if (other.camera == camera.get())
+			{
+				other.lod = lod;
+				return;
+			}
+		}
+
+		if (entry == nullptr)
+		{
+			m_CameraLODs.push_back(CameraLOD());
+			entry = &m_CameraLODs.back();
+		}
+
+		entry->camera = camera.get();
+		entry->cameraPtr = camera;
+		entry->lod = lod;
+	}
+
+	void SceneNode::UpdateAABB()
+	{
+		if (m_ModelAABB.GetInfinite())
+		{
+			m_LocalAABB = m_WorldAABB = m_ModelAABB;
+		}
+		else
+		{
+			m_LocalAABB = m_TransformSystem->GetLocalMatrix(m_TransformHandle).Multiply(m_ModelAABB);
+			m_WorldAABB = m_TransformSystem->GetWorldMatrix(m_TransformHandle).Multiply(m_ModelAABB);
+		}
+	}
+
+	void SceneNode::UpdateSceneManager()
+	{
+		if (auto manager = GetAttachedManager())
+			manager->UpdateSceneNode(shared_from_this());
+	}
+
+	SceneManager *SceneNode::GetAttachedManager() const
+	{
+		if (auto treeNode = m_OcTreeNode.lock())
+			return &treeNode->GetManager();
+		else
+			return m_SceneManager.lock().get();
+	}
+
+	void SceneNode::NotifyTransformChange()
+	{
+		auto self = shared_from_this();
+		UpdateSceneManager();
+
+		if (m_OnTransformChange != nullptr)
+			m_OnTransformChange->Emit(self);
+	}
+
+	const Signal<const SceneNode::Ptr&>::Ptr &SceneNode::OnTransformChange()
+	{
+		if (m_OnTransformChange == nullptr)
+			m_OnTransformChange = Signal<const Ptr&>::Create();
+
+		return m_OnTransformChange;
+	}
+
+	void SceneNode::SetStatic(bool isStatic)
+	{
+		if (isStatic == GetStatic())
+			return;
+
+		m_TransformSystem->SetStatic(m_TransformHandle, isStatic);
+
+		// move between the attached manager's static and dynamic scenenodes.
+		if (auto manager = GetAttachedManager())
+		{
+			auto self = shared_from_this();
+			RemoveFromOcTree(false);
+			manager->AddSceneNode(self);
+		}
+	}
+
+	bool SceneNode::GetStatic() const
+	{
+		return m_TransformSystem->GetStatic(m_TransformHandle);
 	}
 }
\ No newline at end of file
@@ -1,11 +1,13 @@
 #ifndef _FURY_SCENENODE_H_
 #define _FURY_SCENENODE_H_
 
+#include <cstdint>
 #include <unordered_map>
 #include <typeinfo>
 #include <vector>
 
 #include "Fury/BoxBounds.h"
+#include "Fury/Component.h"
 #include "Fury/Entity.h"
 #include "Fury/Quaternion.h"
 #include "Fury/Matrix4.h"
@@ -14,10 +16,22 @@
 
 namespace fury
 {
-	class Component;
+	class Camera;
 
 	class OcTreeNode;
 
+	class SceneManager;
+
+	class TransformSystem;
+
+	class ComponentStore;
+
+	class Prefab;
+
+	class SceneNodeIndex;
+
+	class Scene;
+
 	// To destory a scenenode.
 	// Call node.RemoveFromParent + node.RemoveFromOcTree(true) + node.reset.
 	// This node together with all it's childs will be destoried.
@@ -25,24 +39,85 @@ namespace fury
 	{
 		friend class OcTreeNode;
 
+		friend class SceneManager;
+
+		friend class TransformSystem;
+
+		friend class Prefab;
+
+		friend class SceneNodeIndex;
+
+		friend class Scene;
+
 	public:
 
 		typedef std::shared_ptr<SceneNode> Ptr;
 
+		// main thread only, like destroying one, see TransformSystem.
 		static Ptr Create(const std::string &name);
 
-		// to enable serialization of custom component, registe to this map.
-		static std::unordered_map<std::string, std::function<std::shared_ptr<Component>()>> ComponentRegistry;
+		struct ComponentEntry
+		{
+			// Component::GetTypeId of created components.
+			unsigned int typeId;
+
+			std::function<std::shared_ptr<Component>()> create;
+		};
+
+		// to enable serialization of custom component, registe to this map through RegisterComponent.
+		static std::unordered_map<std::string, ComponentEntry> ComponentRegistry;
+
+		template<class ComponentType>
+		static void RegisterComponent(const std::string &name, const std::function<std::shared_ptr<Component>()> &create);
 
 	protected:
 
+		struct ComponentSlot
+		{
+			unsigned int typeId;
+
+			// in m_ComponentStore's pool of typeId.
+			unsigned int handle;
+
+			// owned by a prefab's source and shared with it's other instances.
+			bool shared;
+		};
+
+		struct CameraLOD
+		{
+			// compared first, cameraPtr only tells if it's still alive.
+			const Camera *camera;
+
+			std::weak_ptr<Camera> cameraPtr;
+
+			unsigned int lod;
+		};
+
 		std::weak_ptr<OcTreeNode> m_OcTreeNode;
 
+		// index in m_OcTreeNode's scenenode list.
+		unsigned int m_OcTreeIndex = 0;
+
+		// attached scene manager, if it's not an OcTree.
+		std::weak_ptr<SceneManager> m_SceneManager;
+
+		// set by m_SceneManager, ie. an index in it's own arrays, see SceneManager::SetManagerIndex.
+		unsigned int m_ManagerIndex = 0;
+
 		std::weak_ptr<SceneNode> m_Parent;
 
 		std::vector<Ptr> m_Childs;
 
-		std::unordered_map<std::type_index, std::shared_ptr<Component>> m_Components;
+		// components live in m_ComponentStore's pools, slots are sorted by type id.
+		// that's the scene's store while this node is below a scene's root, ComponentStore::Active otherwise.
+		std::vector<ComponentSlot> m_Components;
+
+		// bit i is set if a component with type id i is attached, for the first 32 type ids.
+		// these components come first in m_Components, 
+		// one's index is the number of bits set below it's own.
+		uint32_t m_ComponentMask = 0;
+
+		std::shared_ptr<ComponentStore> m_ComponentStore;
 
 		BoxBounds m_ModelAABB;
 
@@ -50,32 +125,32 @@ namespace fury
 
 		BoxBounds m_WorldAABB;
 
-		bool m_TransformDirty;
-
-		Vector4 m_WorldPosition;
+		// transforms live in m_TransformSystem's arrays.
+		std::shared_ptr<TransformSystem> m_TransformSystem;
 
-		Vector4 m_WorldScale;
+		unsigned int m_TransformHandle;
 
-		Quaternion m_WorldRotation;
+		// set on an instance root, which is saved as a reference to it.
+		std::shared_ptr<Prefab> m_Prefab;
 
-		Vector4 m_LocalPosition;
+		// built by a prefab below an instance root, not saved by the scene.
+		bool m_PrefabChild = false;
 
-		Vector4 m_LocalScale;
+		// index of the scene this node is attached to, nullptr if it's not in a scene.
+		std::shared_ptr<SceneNodeIndex> m_NodeIndex;
 
-		Quaternion m_LocalRotation;
+		// path from the scene's root node, see SceneNodeIndex.
+		size_t m_PathHash = 0;
 
-		Matrix4 m_LocalMatrix;
+		// created for the first listener.
+		Signal<const Ptr&>::Ptr m_OnTransformChange;
 
-		Matrix4 m_InvertLocalMatrix;
-
-		Matrix4 m_WorldMatrix;
-
-		Matrix4 m_InvertWorldMatrix;
+		// mesh lod last picked for each camera drawing this node, 
+		// so cameras and prefab instances sharing a MeshRender keep their own lod hysteresis.
+		std::vector<CameraLOD> m_CameraLODs;
 
 	public:
 
-		Signal<const Ptr&>::Ptr OnTransformChange;
-
 		SceneNode(const std::string &name);
 
 		virtual ~SceneNode();
@@ -84,13 +159,18 @@ namespace fury
 
 		virtual void Save(void* wrapper, bool object = true) override;
 
+		// renaming also updates the scene's index.
+		virtual size_t SetName(const std::string &name) override;
+
 		// copies components and translations.
 		Ptr Clone(const std::string &name) const;
 
-		// remove this sceneNode from attached ocTree.
+		// remove this sceneNode from attached ocTree or scene manager.
 		// set recursively to true will call this on child nodes.
 		void RemoveFromOcTree(bool recursively = false);
 
+		std::shared_ptr<OcTreeNode> GetOcTreeNode() const;
+
 		void SetModelAABB(const BoxBounds &aabb);
 
 		BoxBounds GetModelAABB() const;
@@ -99,12 +179,38 @@ namespace fury
 
 		BoxBounds GetWorldAABB() const;
 
+		// SceneNodeCategory flags of attached components.
+		unsigned int GetCategories() const;
+
+		// let attached ocTree recount this scenenode's categories.
+		void UpdateCategories();
+
+		// last lod kept by SetCurrentLOD for camera, 0 if there's none.
+		unsigned int GetCurrentLOD(const std::shared_ptr<Camera> &camera) const;
+
+		void SetCurrentLOD(const std::shared_ptr<Camera> &camera, unsigned int lod);
+
+		// allocated by the first call, so scenenodes without listeners don't carry a signal.
+		const Signal<const Ptr&>::Ptr &OnTransformChange();
+
+		// static scenenodes have their world matrix and aabb baked by the next flush or Recompose, 
+		// then ignore their own and their parents' transform changes until they're not static anymore.
+		// OcTree keeps them in a separate tree, see OcTree::BuildStatic.
+		void SetStatic(bool isStatic);
+
+		bool GetStatic() const;
+
 		//////////////////////////////////
 		// Transforms
 		//////////////////////////////////
 
+		// recompute this node's transform right away if it's dirty, and all descendants' after it.
+		// every node is moved in scene manager and notified on it's own, 
+		// Scene::FlushTransforms does the same for all dirty nodes once per frame.
 		void Recompose(bool force = false);
 
+		std::shared_ptr<TransformSystem> GetTransformSystem() const;
+
 		Matrix4 GetLocalMatrix() const;
 
 		Matrix4 GetInvertLocalMatrix() const;
@@ -176,16 +282,27 @@ namespace fury
 
 		Ptr FindChild(size_t hashcode) const;
 
+		// uses the scene's index if this node is in a scene, a scan of all descendants otherwise.
+		// if several descendants share the name, the one indexed first is returned, see SceneNodeIndex.
 		Ptr FindChildRecursively(size_t hashcode) const;
 
+		// path of child names separated by '/', relative to this node, like "Armature/Hips/Spine".
+		Ptr FindChildByPath(const std::string &path) const;
+
 		unsigned int GetChildCount() const;
 
+		std::shared_ptr<SceneNodeIndex> GetNodeIndex() const;
+
+		size_t GetPathHash() const;
+
 		Ptr GetChildAt(unsigned int index) const;
 
 		//////////////////////////////////
 		// Components
 		//////////////////////////////////
 
+		// attaching and detaching is main thread only, lookups may run on several threads meanwhile nothing attaches, 
+		// see ComponentStore.
 		bool AddComponent(const std::shared_ptr<Component> &ptr);
 
 		bool RemoveComponent(std::type_index type);
@@ -195,19 +312,94 @@ namespace fury
 
 		std::shared_ptr<Component> GetComponent(std::type_index type) const;
 
+		// nullptr if not attached, returns a reference so lookups don't touch reference counts.
+		const std::shared_ptr<Component> &GetComponent(unsigned int typeId) const;
+
+		// a prefab instance's shared component is replaced by a clone of it's own first,
+		// call this instead of GetComponent before modifying a component.
+		template<class ComponentType>
+		std::shared_ptr<ComponentType> GetUniqueComponent();
+
 		void RemoveAllComponents(bool destructing = false);
 
+		std::shared_ptr<ComponentStore> GetComponentStore() const;
+
+		// prefab this node is an instance root of, nullptr if it isn't.
+		std::shared_ptr<Prefab> GetPrefab() const;
+
 	protected:
 
 		void SetOcTreeNode(const std::shared_ptr<OcTreeNode> &ocTreeNode);
 
 		void SetParent(const Ptr &parent);
+
+		// move this node and it's descendants to index, recomputing their path hashes.
+		void SetNodeIndex(const std::shared_ptr<SceneNodeIndex> &index);
+
+		// move components of this node and it's descendants to store.
+		void SetComponentStore(const std::shared_ptr<ComponentStore> &store);
+
+		// recompute local/world aabbs from model aabb.
+		void UpdateAABB();
+
+		// notify attached ocTree or scene manager that world aabb changed.
+		void UpdateSceneManager();
+
+		// attached ocTree or scene manager, nullptr if none.
+		SceneManager *GetAttachedManager() const;
+
+		// scene manager update and OnTransformChange, after the transform is recomputed.
+		void NotifyTransformChange();
+
+		bool RemoveComponent(unsigned int typeId);
+
+		// attach a prefab's component without taking ownership, no OnAttaching.
+		void AddSharedComponent(unsigned int typeId, const std::shared_ptr<Component> &ptr);
+
+		std::shared_ptr<Component> MakeComponentUnique(unsigned int typeId);
+
+		// slot of typeId, m_Components.end() if none.
+		std::vector<ComponentSlot>::iterator FindComponentSlot(unsigned int typeId);
+
+		// components a prefab instance or prefab child loads replace the ones it was built with.
+		bool LoadComponents(const void* wrapper);
+
+		bool LoadChilds(const void* wrapper);
+
+		// components that aren't shared with a prefab.
+		void SaveComponents(void* wrapper);
+
+		// childs that weren't built by a prefab.
+		void SaveChilds(void* wrapper);
+
+		// one override per prefab child below this node that differs from it's counterpart below source, 
+		// keyed by it's path hash relative to the instance root, see Prefab::Overrides.
+		// counts is the number of prefab childs saved so far for each path hash.
+		void SavePrefabOverrides(void* wrapper, const SceneNode *source, size_t pathHash, std::unordered_map<size_t, unsigned int> &counts);
+
+		// applies an override saved by SavePrefabOverrides, called by Prefab while instantiating.
+		bool LoadPrefabOverride(const void* wrapper);
 	};
 
+	template<class ComponentType>
+	void SceneNode::RegisterComponent(const std::string &name, const std::function<std::shared_ptr<Component>()> &create)
+	{
+		ComponentEntry entry;
+		entry.typeId = Component::GetTypeId<ComponentType>();
+		entry.create = create;
+		ComponentRegistry[name] = entry;
+	}
+
 	template<class ComponentType>
 	std::shared_ptr<ComponentType> SceneNode::GetComponent() const
 	{
-		return std::static_pointer_cast<ComponentType>(GetComponent(typeid(ComponentType)));
+		return std::static_pointer_cast<ComponentType>(GetComponent(Component::GetTypeId<ComponentType>()));
+	}
+
+	template<class ComponentType>
+	std::shared_ptr<ComponentType> SceneNode::GetUniqueComponent()
+	{
+		return std::static_pointer_cast<ComponentType>(MakeComponentUnique(Component::GetTypeId<ComponentType>()));
 	}
 }
 
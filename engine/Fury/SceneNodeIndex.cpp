@@ -0,0 +1,130 @@
+#include <algorithm>
+
+#include "Fury/SceneNode.h"
+#include "Fury/SceneNodeIndex.h"
+
+namespace fury
+{
+	SceneNodeIndex::Ptr SceneNodeIndex::Create()
+	{
+		return std::make_shared<SceneNodeIndex>();
+	}
+
+	size_t SceneNodeIndex::CombinePath(size_t parentPathHash, size_t hashcode)
+	{
+		return parentPathHash ^ (hashcode + 0x9e3779b9 + (parentPathHash << 6) + (parentPathHash >> 2));
+	}
+
+	void SceneNodeIndex::Add(SceneNode *node)
+	{
+		Insert(m_Names, node->GetHashCode(), node);
+		Insert(m_Paths, node->m_PathHash, node);
+		m_Count++;
+	}
+
+	void SceneNodeIndex::Remove(SceneNode *node)
+	{
+		if (Erase(m_Names, node->GetHashCode(), node))
+			m_Count--;
+
+		Erase(m_Paths, node->m_PathHash, node);
+	}
+
+	std::shared_ptr<SceneNode> SceneNodeIndex::Find(size_t hashcode) const
+	{
+		return First(m_Names, hashcode);
+	}
+
+	std::shared_ptr<SceneNode> SceneNodeIndex::Find(size_t hashcode, const SceneNode *ancestor) const
+	{
+		auto it = m_Names.find(hashcode);
+		if (it == m_Names.end())
+			return nullptr;
+
+		for (auto node : it->second)
+		{
+			for (auto parent = node->m_Parent.lock(); parent != nullptr; parent = parent->m_Parent.lock())
+			{
+				if (parent.get() == ancestor)
+					return node->shared_from_this();
+			}
+		}
+
+		return nullptr;
+	}
+
+	std::vector<std::shared_ptr<SceneNode>> SceneNodeIndex::FindAll(size_t hashcode) const
+	{
+		std::vector<std::shared_ptr<SceneNode>> nodes;
+
+		auto it = m_Names.find(hashcode);
+		if (it != m_Names.end())
+		{
+			nodes.reserve(it->second.size());
+			for (auto node : it->second)
+				nodes.push_back(node->shared_from_this());
+		}
+
+		return nodes;
+	}
+
+	std::shared_ptr<SceneNode> SceneNodeIndex::FindPath(size_t pathHash) const
+	{
+		return First(m_Paths, pathHash);
+	}
+
+	std::shared_ptr<SceneNode> SceneNodeIndex::FindPath(size_t pathHash, const SceneNode *ancestor, unsigned int depth) const
+	{
+		auto it = m_Paths.find(pathHash);
+		if (it == m_Paths.end())
+			return nullptr;
+
+		// siblings of ancestor may share it's name, and so the path hash.
+		for (auto node : it->second)
+		{
+			auto parent = node->m_Parent.lock();
+			for (unsigned int i = 1; i < depth && parent != nullptr; i++)
+				parent = parent->m_Parent.lock();
+
+			if (parent.get() == ancestor)
+				return node->shared_from_this();
+		}
+
+		return nullptr;
+	}
+
+	unsigned int SceneNodeIndex::GetCount() const
+	{
+		return m_Count;
+	}
+
+	void SceneNodeIndex::Insert(std::unordered_map<size_t, std::vector<SceneNode*>> &map, size_t key, SceneNode *node)
+	{
+		map[key].push_back(node);
+	}
+
+	bool SceneNodeIndex::Erase(std::unordered_map<size_t, std::vector<SceneNode*>> &map, size_t key, SceneNode *node)
+	{
+		auto it = map.find(key);
+		if (it == map.end())
+			return false;
+
+		// search from the back, childs are mostly detached in reverse order.
+		auto &nodes = it->second;
+		auto found = std::find(nodes.rbegin(), nodes.rend(), node);
+		if (found == nodes.rend())
+			return false;
+
+		nodes.erase(std::next(found).base());
+		if (nodes.empty())
+			map.erase(it);
+
+		return true;
+	}
+
+	std::shared_ptr<SceneNode> SceneNodeIndex::First(const std::unordered_map<size_t, std::vector<SceneNode*>> &map, size_t key)
+	{
+		auto it = map.find(key);
+		return it != map.end() ? it->second.front()->shared_from_this() : nullptr;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef _FURY_SCENENODE_INDEX_H_
+#define _FURY_SCENENODE_INDEX_H_
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Fury/Macros.h"
+
+namespace fury
+{
+	class SceneNode;
+
+	/**
+	 *	Name and path hash lookup of all scenenodes below a scene's root node.
+	 *
+	 *	Scenenodes add and remove themselves when they're attached to or detached from the root's tree,
+	 *	and when they're renamed. The root itself isn't indexed.
+	 *	A path hash is SceneNodeIndex::CombinePath of the path hash of it's parent and it's own name hash,
+	 *	the root's path hash is 0.
+	 *
+	 *	Names aren't unique, Find returns the scenenode indexed first among those sharing a name,
+	 *	which keeps it's place until it's detached or renamed. FindAll returns all of them in that order.
+	 *	Paths follow the same rule for siblings sharing a name.
+	 */
+	class FURY_API SceneNodeIndex
+	{
+	public:
+
+		typedef std::shared_ptr<SceneNodeIndex> Ptr;
+
+		static Ptr Create();
+
+		static size_t CombinePath(size_t parentPathHash, size_t hashcode);
+
+	protected:
+
+		std::unordered_map<size_t, std::vector<SceneNode*>> m_Names;
+
+		std::unordered_map<size_t, std::vector<SceneNode*>> m_Paths;
+
+		unsigned int m_Count = 0;
+
+	public:
+
+		// uses node's current hash code and path hash, remove it before they change.
+		void Add(SceneNode *node);
+
+		void Remove(SceneNode *node);
+
+		std::shared_ptr<SceneNode> Find(size_t hashcode) const;
+
+		// only scenenodes below ancestor, which walks up each candidate's parents.
+		std::shared_ptr<SceneNode> Find(size_t hashcode, const SceneNode *ancestor) const;
+
+		std::vector<std::shared_ptr<SceneNode>> FindAll(size_t hashcode) const;
+
+		std::shared_ptr<SceneNode> FindPath(size_t pathHash) const;
+
+		// only scenenodes depth levels below ancestor, for paths relative to it.
+		std::shared_ptr<SceneNode> FindPath(size_t pathHash, const SceneNode *ancestor, unsigned int depth) const;
+
+		unsigned int GetCount() const;
+
+	protected:
+
+		static void Insert(std::unordered_map<size_t, std::vector<SceneNode*>> &map, size_t key, SceneNode *node);
+
+		// false if node wasn't in map under key.
+		static bool Erase(std::unordered_map<size_t, std::vector<SceneNode*>> &map, size_t key, SceneNode *node);
+
+		static std::shared_ptr<SceneNode> First(const std::unordered_map<size_t, std::vector<SceneNode*>> &map, size_t key);
+	};
+}
+
+#endif // _FURY_SCENENODE_INDEX_H_
\ No newline at end of file
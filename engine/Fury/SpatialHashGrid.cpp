@@ -0,0 +1,495 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Fury/Collidable.h"
+#include "Fury/SpatialHashGrid.h"
+#include "Fury/SceneNode.h"
+#include "Fury/Log.h"
+
+namespace fury
+{
+	const unsigned int SpatialHashGrid::INVALID_INDEX = 0xffffffff;
+
+	// cell coords are packed into 21 bits per axis.
+	static const int CELL_COORD_LIMIT = 1 << 20;
+
+	static uint64_t GetCellKey(int x, int y, int z)
+	{
+		const uint64_t mask = (1 << 21) - 1;
+		return (((uint64_t)(x + CELL_COORD_LIMIT) & mask) << 42) |
+			(((uint64_t)(y + CELL_COORD_LIMIT) & mask) << 21) |
+			((uint64_t)(z + CELL_COORD_LIMIT) & mask);
+	}
+
+	SpatialHashGrid::Ptr SpatialHashGrid::Create(float cellSize, unsigned int maxCellSpan)
+	{
+		return std::make_shared<SpatialHashGrid>(cellSize, maxCellSpan);
+	}
+
+	SpatialHashGrid::SpatialHashGrid(float cellSize, unsigned int maxCellSpan) :
+		m_TypeIndex(typeid(SpatialHashGrid)), m_CellSize(cellSize), m_InvCellSize(1.0f / cellSize),
+		m_MaxCellSpan(std::max(maxCellSpan, 1u))
+	{
+
+	}
+
+	SpatialHashGrid::~SpatialHashGrid()
+	{
+		Clear();
+		FURYD << "SpatialHashGrid::~SpatialHashGrid";
+	}
+
+	std::type_index SpatialHashGrid::GetTypeIndex() const
+	{
+		return m_TypeIndex;
+	}
+
+	void SpatialHashGrid::AddSceneNode(const SceneNode::Ptr &sceneNode)
+	{
+		if (FindEntry(*sceneNode) != INVALID_INDEX)
+		{
+			UpdateSceneNode(sceneNode);
+			return;
+		}
+
+		unsigned int entryIndex = m_Entries.size();
+
+		Entry entry;
+		entry.sceneNode = sceneNode;
+		entry.large = INVALID_INDEX;
+		entry.stamp = 0;
+
+		m_Entries.push_back(std::move(entry));
+		SetManagerIndex(*sceneNode, entryIndex);
+
+		SetSceneManager(*sceneNode, shared_from_this());
+		AddToCells(entryIndex, sceneNode->GetWorldAABB());
+		RecordChange(sceneNode.get(), false);
+	}
+
+	void SpatialHashGrid::RemoveSceneNode(const SceneNode::Ptr &sceneNode)
+	{
+		unsigned int entryIndex = FindEntry(*sceneNode);
+		if (entryIndex == INVALID_INDEX)
+			return;
+
+		RemoveFromCells(entryIndex);
+		SetSceneManager(*sceneNode, nullptr);
+		RecordChange(sceneNode.get(), true);
+
+		// swap with the last entry, and point it's cells to the new index.
+		unsigned int lastIndex = m_Entries.size() - 1;
+		if (entryIndex != lastIndex)
+		{
+			Entry &entry = m_Entries[entryIndex];
+			entry = std::move(m_Entries[lastIndex]);
+			SetManagerIndex(*entry.sceneNode, entryIndex);
+
+			if (entry.large != INVALID_INDEX)
+				m_LargeEntries[entry.large] = entryIndex;
+
+			for (auto &ref : entry.cells)
+				m_Cells[ref.cell].entries[ref.slot] = entryIndex;
+		}
+		m_Entries.pop_back();
+	}
+
+	void SpatialHashGrid::UpdateSceneNode(const SceneNode::Ptr &sceneNode)
+	{
+		unsigned int entryIndex = FindEntry(*sceneNode);
+		if (entryIndex == INVALID_INDEX)
+		{
+			AddSceneNode(sceneNode);
+			return;
+		}
+
+		RecordChange(sceneNode.get(), false);
+
+		const BoxBounds &aabb = sceneNode->GetWorldAABB();
+		Entry &entry = m_Entries[entryIndex];
+
+		// most updates are small moves that stay in the same cells, only the cached bounds change.
+		if (entry.large == INVALID_INDEX && IsInCellRange(entry, aabb))
+		{
+			for (auto &ref : entry.cells)
+				m_Cells[ref.cell].bounds.Set(ref.slot, aabb);
+			return;
+		}
+
+		int min[3], max[3];
+		bool inCells = GetCellRange(aabb, min, max);
+
+		if (!inCells && entry.large != INVALID_INDEX)
+		{
+			m_LargeBounds.Set(entry.large, aabb);
+			return;
+		}
+
+		if (inCells && entry.large == INVALID_INDEX)
+		{
+			MoveCells(entryIndex, min, max, aabb);
+			return;
+		}
+
+		RemoveFromCells(entryIndex);
+		AddToCells(entryIndex, aabb);
+	}
+
+	void SpatialHashGrid::WalkScene(const Collidable &collider, const FilterFunc &filterFunc) const
+	{
+		unsigned int stamp = ++m_QueryStamp;
+		if (stamp == 0)
+		{
+			for (auto &entry : m_Entries)
+				entry.stamp = 0;
+			stamp = m_QueryStamp = 1;
+		}
+
+		std::vector<unsigned char> results;
+
+		if (m_LargeEntries.size() > 0)
+		{
+			results.resize(m_LargeEntries.size());
+			collider.IsInsideFastBatch(m_LargeBounds, 0, m_LargeEntries.size(), results.data());
+
+			for (unsigned int i = 0; i < m_LargeEntries.size(); i++)
+			{
+				if (results[i])
+					filterFunc(m_Entries[m_LargeEntries[i]].sceneNode);
+			}
+		}
+
+		if (m_Cells.size() == 0)
+			return;
+
+		std::vector<unsigned char> cellResults(m_Cells.size());
+		collider.IsInsideFastBatch(m_CellBounds, 0, m_Cells.size(), cellResults.data());
+
+		for (unsigned int i = 0; i < m_Cells.size(); i++)
+		{
+			if (!cellResults[i])
+				continue;
+
+			const Cell &cell = m_Cells[i];
+			unsigned int count = cell.entries.size();
+
+			results.resize(count);
+			collider.IsInsideFastBatch(cell.bounds, 0, count, results.data());
+
+			for (unsigned int j = 0; j < count; j++)
+			{
+				if (!results[j])
+					continue;
+
+				const Entry &entry = m_Entries[cell.entries[j]];
+				if (entry.stamp != stamp)
+				{
+					entry.stamp = stamp;
+					filterFunc(entry.sceneNode);
+				}
+			}
+		}
+	}
+
+	void SpatialHashGrid::Reset(float cellSize)
+	{
+		m_CellSize = cellSize;
+		m_InvCellSize = 1.0f / cellSize;
+
+		m_Cells.clear();
+		m_CellBounds.Clear();
+		m_CellMap.clear();
+		m_FreeCells.clear();
+		m_LargeEntries.clear();
+		m_LargeBounds.Clear();
+
+		for (unsigned int i = 0; i < m_Entries.size(); i++)
+		{
+			m_Entries[i].cells.clear();
+			m_Entries[i].large = INVALID_INDEX;
+			AddToCells(i, m_Entries[i].sceneNode->GetWorldAABB());
+		}
+	}
+
+	void SpatialHashGrid::Clear()
+	{
+		for (auto &entry : m_Entries)
+			SetSceneManager(*entry.sceneNode, nullptr);
+
+		m_Entries.clear();
+		m_Cells.clear();
+		m_CellBounds.Clear();
+		m_CellMap.clear();
+		m_FreeCells.clear();
+		m_LargeEntries.clear();
+		m_LargeBounds.Clear();
+
+		RecordReset();
+	}
+
+	float SpatialHashGrid::GetCellSize() const
+	{
+		return m_CellSize;
+	}
+
+	unsigned int SpatialHashGrid::GetCellCount() const
+	{
+		return m_Cells.size();
+	}
+
+	unsigned int SpatialHashGrid::GetSceneNodeCount() const
+	{
+		return m_Entries.size();
+	}
+
+	unsigned int SpatialHashGrid::FindEntry(const SceneNode &sceneNode) const
+	{
+		unsigned int entryIndex = GetManagerIndex(sceneNode);
+		if (entryIndex < m_Entries.size() && m_Entries[entryIndex].sceneNode.get() == &sceneNode)
+			return entryIndex;
+
+		return INVALID_INDEX;
+	}
+
+	bool SpatialHashGrid::GetCellRange(const BoxBounds &aabb, int *min, int *max) const
+	{
+		if (aabb.GetInfinite())
+			return false;
+
+		Vector4 aabbMin = aabb.GetMin();
+		Vector4 aabbMax = aabb.GetMax();
+
+		float mins[3] = { aabbMin.x, aabbMin.y, aabbMin.z };
+		float maxs[3] = { aabbMax.x, aabbMax.y, aabbMax.z };
+
+		uint64_t span = 1;
+		for (int i = 0; i < 3; i++)
+		{
+			float lower = std::floor(mins[i] * m_InvCellSize);
+			float upper = std::floor(maxs[i] * m_InvCellSize);
+
+			// objects far outside the addressable range are treated as large ones.
+			if (!(lower >= -CELL_COORD_LIMIT && upper < CELL_COORD_LIMIT))
+				return false;
+
+			min[i] = (int)lower;
+			max[i] = (int)upper;
+			span *= (uint64_t)(max[i] - min[i] + 1);
+		}
+
+		return span <= m_MaxCellSpan;
+	}
+
+	bool SpatialHashGrid::IsInCellRange(const Entry &entry, const BoxBounds &aabb) const
+	{
+		if (aabb.GetInfinite())
+			return false;
+
+		Vector4 aabbMin = aabb.GetMin();
+		Vector4 aabbMax = aabb.GetMax();
+
+		float mins[3] = { aabbMin.x, aabbMin.y, aabbMin.z };
+		float maxs[3] = { aabbMax.x, aabbMax.y, aabbMax.z };
+
+		// same cell edges as SetCellCoord.
+		for (int i = 0; i < 3; i++)
+		{
+			float lower = entry.min[i] * m_CellSize;
+			float upper = entry.max[i] * m_CellSize;
+
+			if (mins[i] < lower || mins[i] >= lower + m_CellSize || maxs[i] < upper || maxs[i] >= upper + m_CellSize)
+				return false;
+		}
+
+		return true;
+	}
+
+	void SpatialHashGrid::AddToCells(unsigned int entryIndex, const BoxBounds &aabb)
+	{
+		Entry &entry = m_Entries[entryIndex];
+
+		if (!GetCellRange(aabb, entry.min, entry.max))
+		{
+			entry.large = m_LargeEntries.size();
+			m_LargeEntries.push_back(entryIndex);
+			m_LargeBounds.Add(aabb);
+			return;
+		}
+
+		for (int x = entry.min[0]; x <= entry.max[0]; x++)
+		{
+			for (int y = entry.min[1]; y <= entry.max[1]; y++)
+			{
+				for (int z = entry.min[2]; z <= entry.max[2]; z++)
+				{
+					unsigned int cellIndex = GetOrCreateCell(x, y, z);
+					Cell &cell = m_Cells[cellIndex];
+
+					CellRef ref;
+					ref.cell = cellIndex;
+					ref.slot = cell.entries.size();
+
+					cell.entries.push_back(entryIndex);
+					cell.bounds.Add(aabb);
+					entry.cells.push_back(ref);
+				}
+			}
+		}
+	}
+
+	void SpatialHashGrid::MoveCells(unsigned int entryIndex, const int *min, const int *max, const BoxBounds &aabb)
+	{
+		Entry &entry = m_Entries[entryIndex];
+
+		// cells in both ranges keep their slot, the others leave.
+		for (unsigned int i = 0; i < entry.cells.size();)
+		{
+			CellRef ref = entry.cells[i];
+			const int *coord = m_Cells[ref.cell].coord;
+
+			if (coord[0] >= min[0] && coord[0] <= max[0] && coord[1] >= min[1] && coord[1] <= max[1] && 
+				coord[2] >= min[2] && coord[2] <= max[2])
+			{
+				m_Cells[ref.cell].bounds.Set(ref.slot, aabb);
+				i++;
+			}
+			else
+			{
+				RemoveFromCell(entryIndex, i);
+			}
+		}
+
+		// only cells new to the range are looked up.
+		for (int x = min[0]; x <= max[0]; x++)
+		{
+			for (int y = min[1]; y <= max[1]; y++)
+			{
+				for (int z = min[2]; z <= max[2]; z++)
+				{
+					if (x >= entry.min[0] && x <= entry.max[0] && y >= entry.min[1] && y <= entry.max[1] && 
+						z >= entry.min[2] && z <= entry.max[2])
+						continue;
+
+					unsigned int cellIndex = GetOrCreateCell(x, y, z);
+					Cell &cell = m_Cells[cellIndex];
+
+					CellRef ref;
+					ref.cell = cellIndex;
+					ref.slot = cell.entries.size();
+
+					cell.entries.push_back(entryIndex);
+					cell.bounds.Add(aabb);
+					entry.cells.push_back(ref);
+				}
+			}
+		}
+
+		std::copy(min, min + 3, entry.min);
+		std::copy(max, max + 3, entry.max);
+	}
+
+	void SpatialHashGrid::RemoveFromCells(unsigned int entryIndex)
+	{
+		Entry &entry = m_Entries[entryIndex];
+
+		if (entry.large != INVALID_INDEX)
+		{
+			unsigned int lastLarge = m_LargeEntries.size() - 1;
+			if (entry.large != lastLarge)
+			{
+				m_LargeEntries[entry.large] = m_LargeEntries[lastLarge];
+				m_Entries[m_LargeEntries[entry.large]].large = entry.large;
+			}
+			m_LargeEntries.pop_back();
+			m_LargeBounds.RemoveSwap(entry.large);
+
+			entry.large = INVALID_INDEX;
+			return;
+		}
+
+		while (entry.cells.size() > 0)
+			RemoveFromCell(entryIndex, entry.cells.size() - 1);
+	}
+
+	void SpatialHashGrid::RemoveFromCell(unsigned int entryIndex, unsigned int refIndex)
+	{
+		Entry &entry = m_Entries[entryIndex];
+		CellRef ref = entry.cells[refIndex];
+		Cell &cell = m_Cells[ref.cell];
+
+		// swap with the last entry of the cell, and fix the moved entry's slot.
+		unsigned int lastSlot = cell.entries.size() - 1;
+		if (ref.slot != lastSlot)
+		{
+			unsigned int moved = cell.entries[lastSlot];
+			cell.entries[ref.slot] = moved;
+
+			for (auto &movedRef : m_Entries[moved].cells)
+			{
+				if (movedRef.cell == ref.cell)
+				{
+					movedRef.slot = ref.slot;
+					break;
+				}
+			}
+		}
+		cell.entries.pop_back();
+		cell.bounds.RemoveSwap(ref.slot);
+
+		if (cell.entries.empty() && !cell.free)
+		{
+			cell.free = true;
+			m_FreeCells.push_back(ref.cell);
+		}
+
+		entry.cells[refIndex] = entry.cells.back();
+		entry.cells.pop_back();
+	}
+
+	unsigned int SpatialHashGrid::GetOrCreateCell(int x, int y, int z)
+	{
+		uint64_t key = GetCellKey(x, y, z);
+
+		auto it = m_CellMap.find(key);
+		if (it != m_CellMap.end())
+			return it->second;
+
+		while (m_FreeCells.size() > 0)
+		{
+			unsigned int cellIndex = m_FreeCells.back();
+			m_FreeCells.pop_back();
+
+			Cell &cell = m_Cells[cellIndex];
+			cell.free = false;
+
+			if (cell.entries.empty())
+			{
+				m_CellMap.erase(GetCellKey(cell.coord[0], cell.coord[1], cell.coord[2]));
+				m_CellMap.emplace(key, cellIndex);
+				SetCellCoord(cellIndex, x, y, z);
+				return cellIndex;
+			}
+		}
+
+		unsigned int cellIndex = m_Cells.size();
+		m_Cells.push_back(Cell());
+		m_Cells.back().free = false;
+		m_CellBounds.Resize(cellIndex + 1);
+		m_CellMap.emplace(key, cellIndex);
+		SetCellCoord(cellIndex, x, y, z);
+
+		return cellIndex;
+	}
+
+	void SpatialHashGrid::SetCellCoord(unsigned int cellIndex, int x, int y, int z)
+	{
+		Cell &cell = m_Cells[cellIndex];
+		cell.coord[0] = x;
+		cell.coord[1] = y;
+		cell.coord[2] = z;
+
+		Vector4 min(x * m_CellSize, y * m_CellSize, z * m_CellSize);
+		Vector4 max(min.x + m_CellSize, min.y + m_CellSize, min.z + m_CellSize);
+		m_CellBounds.Set(cellIndex, BoxBounds(min, max));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+#ifndef _FURY_SPATIAL_HASH_GRID_H_
+#define _FURY_SPATIAL_HASH_GRID_H_
+
+#include <vector>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Fury/BoxBounds.h"
+#include "Fury/BoxBoundsArray.h"
+#include "Fury/SceneManager.h"
+
+namespace fury
+{
+	/**
+	 *	Sparse uniform grid, only cells that hold or held objects are allocated.
+	 *
+	 *	An object is registered to every cell it's aabb overlaps,
+	 *	moving an object only touches it's own cells, there is no tree to rebalance.
+	 *	Objects that overlap more than 'maxCellSpan' cells and infinite ones
+	 *	are kept in a separate list and tested individually.
+	 *
+	 *	Queries test occupied cells first, then objects inside intersecting cells.
+	 *	Objects seen through several cells are reported once, using a per query stamp,
+	 *	so a grid can't be walked by more than one thread at a time.
+	 */
+	class FURY_API SpatialHashGrid : public SceneManager, public std::enable_shared_from_this<SpatialHashGrid>
+	{
+	public:
+
+		typedef std::shared_ptr<SpatialHashGrid> Ptr;
+
+		static Ptr Create(float cellSize = 16.0f, unsigned int maxCellSpan = 64);
+
+		static const unsigned int INVALID_INDEX;
+
+	protected:
+
+		struct CellRef
+		{
+			unsigned int cell;
+
+			// index in the cell's entry list.
+			unsigned int slot;
+		};
+
+		struct Cell
+		{
+			int coord[3];
+
+			// true while the cell is in m_FreeCells.
+			bool free;
+
+			std::vector<unsigned int> entries;
+
+			// world aabbs of entries, same index as entries.
+			BoxBoundsArray bounds;
+		};
+
+		struct Entry
+		{
+			std::shared_ptr<SceneNode> sceneNode;
+
+			// overlapped cell range, inclusive.
+			int min[3], max[3];
+
+			std::vector<CellRef> cells;
+
+			// index in m_LargeEntries, INVALID_INDEX if the entry lives in cells.
+			unsigned int large;
+
+			mutable unsigned int stamp;
+		};
+
+		std::type_index m_TypeIndex;
+
+		float m_CellSize;
+
+		float m_InvCellSize;
+
+		unsigned int m_MaxCellSpan;
+
+		// an entry's index is also kept by it's scenenode, see SceneManager::SetManagerIndex.
+		std::vector<Entry> m_Entries;
+
+		std::vector<Cell> m_Cells;
+
+		// bounds of cells, same index as m_Cells.
+		BoxBoundsArray m_CellBounds;
+
+		std::unordered_map<uint64_t, unsigned int> m_CellMap;
+
+		// cells became empty, they are recycled for new coords so their storage is reused.
+		// may hold cells that got entries again, those are skipped when popped.
+		// each cell is listed once at most.
+		std::vector<unsigned int> m_FreeCells;
+
+		std::vector<unsigned int> m_LargeEntries;
+
+		BoxBoundsArray m_LargeBounds;
+
+		mutable unsigned int m_QueryStamp = 0;
+
+	public:
+
+		SpatialHashGrid(float cellSize, unsigned int maxCellSpan);
+
+		virtual ~SpatialHashGrid();
+
+		virtual std::type_index GetTypeIndex() const;
+
+		virtual void AddSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
+
+		virtual void RemoveSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
+
+		virtual void UpdateSceneNode(const std::shared_ptr<SceneNode> &sceneNode);
+
+		virtual void WalkScene(const Collidable &collider, const FilterFunc &filterFunc) const;
+
+		// re-register all scenenodes with a new cell size.
+		void Reset(float cellSize);
+
+		virtual void Clear();
+
+		float GetCellSize() const;
+
+		// count of allocated cells, including empty ones waiting for reuse.
+		unsigned int GetCellCount() const;
+
+		unsigned int GetSceneNodeCount() const;
+
+	protected:
+
+		// INVALID_INDEX if sceneNode isn't in this grid.
+		unsigned int FindEntry(const SceneNode &sceneNode) const;
+
+		// computes entry's cell range, returns false if the entry should be kept in m_LargeEntries.
+		bool GetCellRange(const BoxBounds &aabb, int *min, int *max) const;
+
+		// true if aabb overlaps the same cells as entry, without flooring it's corners.
+		bool IsInCellRange(const Entry &entry, const BoxBounds &aabb) const;
+
+		void AddToCells(unsigned int entryIndex, const BoxBounds &aabb);
+
+		// registers entry to the cells of range [min, max] only, cells in both ranges are kept.
+		void MoveCells(unsigned int entryIndex, const int *min, const int *max, const BoxBounds &aabb);
+
+		void RemoveFromCells(unsigned int entryIndex);
+
+		// removes entry's refIndex-th cell ref, the last ref takes it's place.
+		void RemoveFromCell(unsigned int entryIndex, unsigned int refIndex);
+
+		unsigned int GetOrCreateCell(int x, int y, int z);
+
+		void SetCellCoord(unsigned int cellIndex, int x, int y, int z);
+	};
+}
+
+#endif // _FURY_SPATIAL_HASH_GRID_H_
\ No newline at end of file
@@ -1,6 +1,9 @@
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include "Fury/BoxBounds.h"
+#include "Fury/BoxBoundsArray.h"
 #include "Fury/SphereBounds.h"
 
 namespace fury
@@ -97,6 +100,32 @@ namespace fury
 		return (m_Center - bsphere.GetCenter()).SquareLength() <= radius * radius;
 	}
 
+	void SphereBounds::IsInsideFastBatch(const BoxBoundsArray &aabbs, unsigned int start, unsigned int count, unsigned char *results) const
+	{
+		if (m_Infinite)
+		{
+			std::fill(results, results + count, 1);
+			return;
+		}
+
+		const float *cx = aabbs.GetCenterX() + start;
+		const float *cy = aabbs.GetCenterY() + start;
+		const float *cz = aabbs.GetCenterZ() + start;
+		const float *ex = aabbs.GetExtentsX() + start;
+		const float *ey = aabbs.GetExtentsY() + start;
+		const float *ez = aabbs.GetExtentsZ() + start;
+
+		float radius2 = m_Radius * m_Radius;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			// distance from sphere center to the closest point of aabb, per axis.
+			float dx = std::max(std::abs(cx[i] - m_Center.x) - ex[i], 0.0f);
+			float dy = std::max(std::abs(cy[i] - m_Center.y) - ey[i], 0.0f);
+			float dz = std::max(std::abs(cz[i] - m_Center.z) - ez[i], 0.0f);
+			results[i] = dx * dx + dy * dy + dz * dz <= radius2 ? 1 : 0;
+		}
+	}
+
 	void SphereBounds::Encapsulate(const BoxBounds &aabb)
 	{
 		if (m_Infinite || aabb.GetInfinite())
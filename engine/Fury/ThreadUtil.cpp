@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <stack>
 
 #include "Fury/Log.h"
@@ -57,6 +58,36 @@ namespace fury
 			worker.join();
 	}
 
+	void ThreadUtil::ParallelFor(unsigned int count, unsigned int minChunk, const std::function<void(unsigned int, unsigned int)> &fn)
+	{
+		if (count == 0)
+			return;
+
+		unsigned int chunkCount = m_Workers.size() + 1;
+		unsigned int chunkSize = std::max(minChunk, (count + chunkCount - 1) / chunkCount);
+
+		if (count <= chunkSize || !IsMainThread())
+		{
+			fn(0, count);
+			return;
+		}
+
+		auto runChunk = [&](unsigned int chunkStart)
+		{
+			fn(chunkStart, std::min(chunkStart + chunkSize, count));
+		};
+
+		std::vector<std::future<void>> futures;
+		for (unsigned int chunkStart = chunkSize; chunkStart < count; chunkStart += chunkSize)
+			futures.push_back(Enqueue(runChunk, chunkStart));
+
+		// calling thread takes the first chunk instead of idling.
+		runChunk(0);
+
+		for (auto &future : futures)
+			future.get();
+	}
+
 	size_t ThreadUtil::GetWorkerCount()
 	{
 		return m_Workers.size();
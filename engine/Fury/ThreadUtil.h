@@ -65,6 +65,11 @@ namespace fury
 			return res;
 		}
 
+		// calls fn with [start, end) chunks of count items, one on each worker and one on the calling thread.
+		// chunks have at least minChunk items but the last, less items are one chunk on the calling thread.
+		// so is everything if the calling thread is a worker, tasks enqueued from a worker could wait on themselves.
+		void ParallelFor(unsigned int count, unsigned int minChunk, const std::function<void(unsigned int, unsigned int)> &fn);
+
 		size_t GetWorkerCount();
 
 		void SetMainThread();
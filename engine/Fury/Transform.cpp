@@ -64,11 +64,11 @@ namespace fury
 
 		if (!m_Owner.expired())
 		{
+			// recomposed by the next Scene::FlushTransforms.
 			auto node = m_Owner.lock();
 			node->SetLocalPosition(m_Position);
 			node->SetLocalRoattion(m_Rotation);
 			node->SetLocalScale(m_Scale);
-			node->Recompose(true);
 		}
 	}
 
@@ -0,0 +1,556 @@
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+#include "Fury/SceneManager.h"
+#include "Fury/SceneNode.h"
+#include "Fury/ThreadUtil.h"
+#include "Fury/TransformSystem.h"
+
+namespace fury
+{
+	TransformSystem::Ptr TransformSystem::Active = nullptr;
+
+	const unsigned int TransformSystem::INVALID_HANDLE = std::numeric_limits<unsigned int>::max();
+
+	const unsigned char TransformSystem::LOCAL_DIRTY;
+
+	const unsigned char TransformSystem::WORLD_CHANGED;
+
+	const unsigned char TransformSystem::LOCAL_UNIFORM;
+
+	const unsigned char TransformSystem::WORLD_UNIFORM;
+
+	const unsigned char TransformSystem::STATIC;
+
+	const unsigned char TransformSystem::FROZEN;
+
+	const unsigned char TransformSystem::INVERT_DIRTY;
+
+	const unsigned char TransformSystem::INVERT_BUSY;
+
+	const unsigned char TransformSystem::INVERT_CLEAN;
+
+	TransformSystem::Ptr TransformSystem::Create()
+	{
+		return std::make_shared<TransformSystem>();
+	}
+
+	TransformSystem::TransformSystem()
+	{
+		m_LevelStarts.push_back(0);
+	}
+
+	unsigned int TransformSystem::Add(SceneNode *owner)
+	{
+		unsigned int handle;
+		if (m_FreeHandles.size() > 0)
+		{
+			handle = m_FreeHandles.back();
+			m_FreeHandles.pop_back();
+		}
+		else
+		{
+			handle = m_Indices.size();
+			m_Indices.push_back(INVALID_HANDLE);
+		}
+
+		m_Indices[handle] = m_Handles.size();
+
+		m_Handles.push_back(handle);
+		m_Owners.push_back(owner);
+		m_ParentHandles.push_back(INVALID_HANDLE);
+		m_ParentIndices.push_back(INVALID_HANDLE);
+		m_Flags.push_back(LOCAL_DIRTY);
+		m_InvertStates.push_back(InvertState());
+		m_LocalPositions.push_back(Vector4());
+		m_LocalRotations.push_back(Quaternion());
+		m_LocalScales.push_back(Vector4(1.0f, 1.0f, 1.0f, 1.0f));
+		m_LocalMatrices.push_back(Matrix4());
+		m_InvertLocalMatrices.push_back(Matrix4());
+		m_WorldMatrices.push_back(Matrix4());
+		m_InvertWorldMatrices.push_back(Matrix4());
+		m_WorldPositions.push_back(Vector4());
+		m_WorldRotations.push_back(Quaternion());
+		m_WorldScales.push_back(Vector4(1.0f, 1.0f, 1.0f, 1.0f));
+
+		m_DirtyCount++;
+		m_OrderDirty = true;
+
+		return handle;
+	}
+
+	void TransformSystem::Remove(unsigned int handle)
+	{
+		unsigned int index = m_Indices[handle];
+		unsigned int last = m_Handles.size() - 1;
+
+		// frozen transforms aren't counted, see SetDirty.
+		if ((m_Flags[index] & (LOCAL_DIRTY | FROZEN)) == LOCAL_DIRTY)
+			m_DirtyCount--;
+
+		// move the last transform to index, order is fixed by the next sort.
+		if (index != last)
+		{
+			m_Handles[index] = m_Handles[last];
+			m_Owners[index] = m_Owners[last];
+			m_ParentHandles[index] = m_ParentHandles[last];
+			m_Flags[index] = m_Flags[last];
+			m_InvertStates[index] = m_InvertStates[last];
+			m_LocalPositions[index] = m_LocalPositions[last];
+			m_LocalRotations[index] = m_LocalRotations[last];
+			m_LocalScales[index] = m_LocalScales[last];
+			m_LocalMatrices[index] = m_LocalMatrices[last];
+			m_InvertLocalMatrices[index] = m_InvertLocalMatrices[last];
+			m_WorldMatrices[index] = m_WorldMatrices[last];
+			m_InvertWorldMatrices[index] = m_InvertWorldMatrices[last];
+			m_WorldPositions[index] = m_WorldPositions[last];
+			m_WorldRotations[index] = m_WorldRotations[last];
+			m_WorldScales[index] = m_WorldScales[last];
+
+			m_Indices[m_Handles[index]] = index;
+		}
+
+		m_Handles.pop_back();
+		m_Owners.pop_back();
+		m_ParentHandles.pop_back();
+		m_ParentIndices.pop_back();
+		m_Flags.pop_back();
+		m_InvertStates.pop_back();
+		m_LocalPositions.pop_back();
+		m_LocalRotations.pop_back();
+		m_LocalScales.pop_back();
+		m_LocalMatrices.pop_back();
+		m_InvertLocalMatrices.pop_back();
+		m_WorldMatrices.pop_back();
+		m_InvertWorldMatrices.pop_back();
+		m_WorldPositions.pop_back();
+		m_WorldRotations.pop_back();
+		m_WorldScales.pop_back();
+
+		m_Indices[handle] = INVALID_HANDLE;
+		m_FreeHandles.push_back(handle);
+
+		m_OrderDirty = true;
+	}
+
+	void TransformSystem::SetParent(unsigned int handle, unsigned int parentHandle)
+	{
+		m_ParentHandles[m_Indices[handle]] = parentHandle;
+		m_OrderDirty = true;
+	}
+
+	unsigned int TransformSystem::GetCount() const
+	{
+		return m_Handles.size();
+	}
+
+	unsigned int TransformSystem::GetParallelThreshold() const
+	{
+		return m_ParallelThreshold;
+	}
+
+	void TransformSystem::SetParallelThreshold(unsigned int threshold)
+	{
+		m_ParallelThreshold = threshold;
+	}
+
+	bool TransformSystem::GetDirty(unsigned int handle) const
+	{
+		return (m_Flags[m_Indices[handle]] & LOCAL_DIRTY) != 0;
+	}
+
+	void TransformSystem::SetDirty(unsigned int handle)
+	{
+		unsigned char &flags = m_Flags[m_Indices[handle]];
+		if ((flags & LOCAL_DIRTY) == 0)
+		{
+			flags |= LOCAL_DIRTY;
+
+			// Update skips frozen transforms, their changes wait until they're not static anymore.
+			if ((flags & FROZEN) == 0)
+				m_DirtyCount++;
+		}
+	}
+
+	bool TransformSystem::GetStatic(unsigned int handle) const
+	{
+		return (m_Flags[m_Indices[handle]] & STATIC) != 0;
+	}
+
+	void TransformSystem::SetStatic(unsigned int handle, bool isStatic)
+	{
+		unsigned char &flags = m_Flags[m_Indices[handle]];
+		if (isStatic == ((flags & STATIC) != 0))
+			return;
+
+		if (isStatic)
+		{
+			// baked by the next Update, with it's parent's current world matrix.
+			flags |= STATIC;
+			SetDirty(handle);
+		}
+		else
+		{
+			// changes made while frozen weren't counted by the Updates since.
+			flags &= ~(STATIC | FROZEN | LOCAL_DIRTY);
+			SetDirty(handle);
+		}
+	}
+
+	bool TransformSystem::GetFrozen(unsigned int handle) const
+	{
+		return (m_Flags[m_Indices[handle]] & FROZEN) != 0;
+	}
+
+	Vector4 TransformSystem::GetLocalPosition(unsigned int handle) const
+	{
+		return m_LocalPositions[m_Indices[handle]];
+	}
+
+	void TransformSystem::SetLocalPosition(unsigned int handle, Vector4 position)
+	{
+		m_LocalPositions[m_Indices[handle]] = position;
+		SetDirty(handle);
+	}
+
+	Quaternion TransformSystem::GetLocalRotation(unsigned int handle) const
+	{
+		return m_LocalRotations[m_Indices[handle]];
+	}
+
+	void TransformSystem::SetLocalRotation(unsigned int handle, Quaternion rotation)
+	{
+		m_LocalRotations[m_Indices[handle]] = rotation;
+		SetDirty(handle);
+	}
+
+	Vector4 TransformSystem::GetLocalScale(unsigned int handle) const
+	{
+		return m_LocalScales[m_Indices[handle]];
+	}
+
+	void TransformSystem::SetLocalScale(unsigned int handle, Vector4 scale)
+	{
+		m_LocalScales[m_Indices[handle]] = scale;
+		SetDirty(handle);
+	}
+
+	const Matrix4 &TransformSystem::GetLocalMatrix(unsigned int handle) const
+	{
+		return m_LocalMatrices[m_Indices[handle]];
+	}
+
+	const Matrix4 &TransformSystem::GetInvertLocalMatrix(unsigned int handle) const
+	{
+		unsigned int index = m_Indices[handle];
+		return GetInverse(m_InvertStates[index].local, m_LocalMatrices[index], m_InvertLocalMatrices[index], 
+			(m_Flags[index] & LOCAL_UNIFORM) != 0);
+	}
+
+	const Matrix4 &TransformSystem::GetWorldMatrix(unsigned int handle) const
+	{
+		return m_WorldMatrices[m_Indices[handle]];
+	}
+
+	const Matrix4 &TransformSystem::GetInvertWorldMatrix(unsigned int handle) const
+	{
+		unsigned int index = m_Indices[handle];
+		return GetInverse(m_InvertStates[index].world, m_WorldMatrices[index], m_InvertWorldMatrices[index], 
+			(m_Flags[index] & WORLD_UNIFORM) != 0);
+	}
+
+	Vector4 TransformSystem::GetWorldPosition(unsigned int handle) const
+	{
+		return m_WorldPositions[m_Indices[handle]];
+	}
+
+	Quaternion TransformSystem::GetWorldRotation(unsigned int handle) const
+	{
+		return m_WorldRotations[m_Indices[handle]];
+	}
+
+	Vector4 TransformSystem::GetWorldScale(unsigned int handle) const
+	{
+		return m_WorldScales[m_Indices[handle]];
+	}
+
+	void TransformSystem::Compose(unsigned int handle)
+	{
+		unsigned int index = m_Indices[handle];
+		unsigned int parentHandle = m_ParentHandles[index];
+		unsigned int parentIndex = parentHandle == INVALID_HANDLE ? INVALID_HANDLE : m_Indices[parentHandle];
+
+		// it's changes weren't counted since it was frozen.
+		if (m_Flags[index] & FROZEN)
+			return;
+
+		if (m_Flags[index] & LOCAL_DIRTY)
+			m_DirtyCount--;
+
+		ComposeIndex(index, parentIndex);
+	}
+
+	unsigned int TransformSystem::Update()
+	{
+		if (m_DirtyCount == 0)
+			return 0;
+
+		if (m_OrderDirty)
+			SortByDepth();
+
+		auto &threadUtil = ThreadUtil::Instance();
+
+		for (unsigned int level = 0; level + 1 < m_LevelStarts.size(); level++)
+		{
+			// transforms of a level only read their parents, which are all in the levels above.
+			unsigned int start = m_LevelStarts[level];
+			threadUtil->ParallelFor(m_LevelStarts[level + 1] - start, m_ParallelThreshold, 
+				[&](unsigned int chunkStart, unsigned int chunkEnd)
+			{
+				UpdateRange(start + chunkStart, start + chunkEnd);
+			});
+		}
+
+		m_DirtyCount = 0;
+
+		// listeners may add, move or destroy scenenodes, keep owners alive before calling them.
+		SceneManager::SceneNodes changed;
+		for (unsigned int i = 0; i < m_Flags.size(); i++)
+		{
+			if (m_Flags[i] & WORLD_CHANGED)
+				changed.push_back(m_Owners[i]->shared_from_this());
+		}
+
+		// one batch per scene manager, usually there's only one.
+		std::vector<std::pair<SceneManager*, SceneManager::SceneNodes>> batches;
+		for (auto &owner : changed)
+		{
+			SceneManager *manager = owner->GetAttachedManager();
+			if (manager == nullptr)
+				continue;
+
+			auto it = std::find_if(batches.begin(), batches.end(), 
+				[manager](const std::pair<SceneManager*, SceneManager::SceneNodes> &batch)
+			{
+				return batch.first == manager;
+			});
+
+			if (it == batches.end())
+			{
+				batches.push_back(std::make_pair(manager, SceneManager::SceneNodes()));
+				it = batches.end() - 1;
+			}
+			it->second.push_back(owner);
+		}
+
+		for (auto &batch : batches)
+			batch.first->UpdateSceneNodes(batch.second);
+
+		// each changed scenenode is notified once, parents first.
+		for (auto &owner : changed)
+		{
+			if (owner->m_OnTransformChange != nullptr)
+				owner->m_OnTransformChange->Emit(owner);
+		}
+
+		return changed.size();
+	}
+
+	void TransformSystem::SortByDepth()
+	{
+		unsigned int count = m_Handles.size();
+
+		std::vector<unsigned int> parentIndices(count, INVALID_HANDLE);
+		std::vector<unsigned int> childStarts(count + 1, 0);
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			unsigned int parentHandle = m_ParentHandles[i];
+			if (parentHandle < m_Indices.size() && m_Indices[parentHandle] != INVALID_HANDLE)
+			{
+				parentIndices[i] = m_Indices[parentHandle];
+				childStarts[parentIndices[i] + 1]++;
+			}
+		}
+
+		for (unsigned int i = 0; i < count; i++)
+			childStarts[i + 1] += childStarts[i];
+
+		std::vector<unsigned int> childs(childStarts[count]);
+		std::vector<unsigned int> cursors(childStarts.begin(), childStarts.end() - 1);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (parentIndices[i] != INVALID_HANDLE)
+				childs[cursors[parentIndices[i]]++] = i;
+		}
+
+		// breadth first from roots, so childs of one parent stay together.
+		std::vector<unsigned int> order;
+		order.reserve(count);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (parentIndices[i] == INVALID_HANDLE)
+				order.push_back(i);
+		}
+
+		m_LevelStarts.clear();
+		m_LevelStarts.push_back(0);
+
+		unsigned int levelStart = 0;
+		while (levelStart < order.size())
+		{
+			unsigned int levelEnd = order.size();
+			m_LevelStarts.push_back(levelEnd);
+
+			for (unsigned int i = levelStart; i < levelEnd; i++)
+			{
+				unsigned int index = order[i];
+				for (unsigned int j = childStarts[index]; j < childStarts[index + 1]; j++)
+					order.push_back(childs[j]);
+			}
+
+			levelStart = levelEnd;
+		}
+
+		// transforms in a parent cycle are never reached, keep them as roots.
+		if (order.size() < count)
+		{
+			std::vector<unsigned char> reached(count, 0);
+			for (auto index : order)
+				reached[index] = 1;
+
+			for (unsigned int i = 0; i < count; i++)
+			{
+				if (reached[i] == 0)
+				{
+					parentIndices[i] = INVALID_HANDLE;
+					order.push_back(i);
+				}
+			}
+			m_LevelStarts.push_back(count);
+		}
+
+		Permute(m_Handles, order);
+		Permute(m_Owners, order);
+		Permute(m_ParentHandles, order);
+		Permute(m_Flags, order);
+		Permute(m_InvertStates, order);
+		Permute(m_LocalPositions, order);
+		Permute(m_LocalRotations, order);
+		Permute(m_LocalScales, order);
+		Permute(m_LocalMatrices, order);
+		Permute(m_InvertLocalMatrices, order);
+		Permute(m_WorldMatrices, order);
+		Permute(m_InvertWorldMatrices, order);
+		Permute(m_WorldPositions, order);
+		Permute(m_WorldRotations, order);
+		Permute(m_WorldScales, order);
+
+		for (unsigned int i = 0; i < count; i++)
+			m_Indices[m_Handles[i]] = i;
+
+		for (unsigned int i = 0; i < count; i++)
+			m_ParentIndices[i] = parentIndices[order[i]] == INVALID_HANDLE ? INVALID_HANDLE : m_Indices[m_ParentHandles[i]];
+
+		m_OrderDirty = false;
+	}
+
+	void TransformSystem::ComposeIndex(unsigned int index, unsigned int parentIndex)
+	{
+		Matrix4 &localMatrix = m_LocalMatrices[index];
+		localMatrix.Identity();
+		localMatrix.AppendTranslation(m_LocalPositions[index]);
+		localMatrix.AppendRotation(m_LocalRotations[index]);
+		localMatrix.AppendScale(m_LocalScales[index]);
+
+		// clears LOCAL_DIRTY, inverses wait for their getters.
+		unsigned char flags = m_Flags[index] & WORLD_CHANGED;
+		m_InvertStates[index].local.store(INVERT_DIRTY, std::memory_order_relaxed);
+		m_InvertStates[index].world.store(INVERT_DIRTY, std::memory_order_relaxed);
+
+		// static transforms are baked by this.
+		if (m_Flags[index] & STATIC)
+			flags |= STATIC | FROZEN;
+
+		const Vector4 &scale = m_LocalScales[index];
+		if (scale.x == scale.y && scale.y == scale.z)
+			flags |= LOCAL_UNIFORM;
+
+		// similarities stay similarities, one non-uniform scale on the way up is enough to lose it.
+		if ((flags & LOCAL_UNIFORM) && (parentIndex == INVALID_HANDLE || (m_Flags[parentIndex] & WORLD_UNIFORM)))
+			flags |= WORLD_UNIFORM;
+
+		m_Flags[index] = flags;
+
+		if (parentIndex == INVALID_HANDLE)
+		{
+			m_WorldMatrices[index] = localMatrix;
+			m_WorldPositions[index] = m_LocalPositions[index];
+			m_WorldRotations[index] = m_LocalRotations[index];
+			m_WorldScales[index] = m_LocalScales[index];
+		}
+		else
+		{
+			const Matrix4 &matrix = m_WorldMatrices[parentIndex];
+			m_WorldMatrices[index] = matrix * localMatrix;
+			m_WorldPositions[index] = matrix.Multiply(m_LocalPositions[index]);
+			m_WorldRotations[index] = matrix.Multiply(m_LocalRotations[index]);
+			m_WorldScales[index] = matrix.Multiply(m_LocalScales[index]);
+		}
+	}
+
+	void TransformSystem::UpdateRange(unsigned int start, unsigned int end)
+	{
+		for (unsigned int i = start; i < end; i++)
+		{
+			// frozen transforms ignore their own and their parents' changes.
+			if (m_Flags[i] & FROZEN)
+			{
+				m_Flags[i] &= ~WORLD_CHANGED;
+				continue;
+			}
+
+			unsigned int parentIndex = m_ParentIndices[i];
+			bool changed = (m_Flags[i] & LOCAL_DIRTY) != 0 ||
+				(parentIndex != INVALID_HANDLE && (m_Flags[parentIndex] & WORLD_CHANGED) != 0);
+
+			if (!changed)
+			{
+				m_Flags[i] &= ~WORLD_CHANGED;
+				continue;
+			}
+
+			ComposeIndex(i, parentIndex);
+			m_Flags[i] |= WORLD_CHANGED;
+
+			// aabbs only belong to their own scenenode, safe to update from workers.
+			m_Owners[i]->UpdateAABB();
+		}
+	}
+
+	const Matrix4 &TransformSystem::GetInverse(std::atomic<unsigned char> &state, const Matrix4 &matrix, Matrix4 &inverse, bool rigid)
+	{
+		// the cached matrix only changes again after a setter or Update, so it's safe to read once filled.
+		unsigned char value = state.load(std::memory_order_acquire);
+		while (value != INVERT_CLEAN)
+		{
+			if (value == INVERT_DIRTY)
+			{
+				// value is reloaded if another thread claimed it first.
+				if (state.compare_exchange_weak(value, INVERT_BUSY, std::memory_order_acquire))
+				{
+					inverse = rigid ? matrix.InverseRigid() : matrix.Inverse();
+					state.store(INVERT_CLEAN, std::memory_order_release);
+					break;
+				}
+			}
+			else
+			{
+				std::this_thread::yield();
+				value = state.load(std::memory_order_acquire);
+			}
+		}
+		return inverse;
+	}
+}
\ No newline at end of file
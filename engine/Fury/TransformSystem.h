@@ -0,0 +1,233 @@
+#ifndef _FURY_TRANSFORM_SYSTEM_H_
+#define _FURY_TRANSFORM_SYSTEM_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "Fury/Matrix4.h"
+#include "Fury/Quaternion.h"
+#include "Fury/Vector4.h"
+
+namespace fury
+{
+	class SceneNode;
+
+	/**
+	 *	Transforms of all scenenodes, each property stored in it's own contiguous array.
+	 *
+	 *	Scenenodes keep handles, a transform's index changes when the arrays are sorted.
+	 *	Arrays are sorted by depth, parents come before childs and childs of one parent are next to each other.
+	 *	Hierarchy changes only mark the order dirty, sorting happens at the next Update.
+	 *
+	 *	Update recomputes dirty transforms and their descendants one depth level at a time,
+	 *	a level only reads the level above it, so it's split into chunks for ThreadUtil's workers.
+	 *
+	 *	Everything that writes, Add and Remove included, is for the main thread only, 
+	 *	so scenenodes are created and destroyed there too. Getters may be called from several threads at once, 
+	 *	ie. from ray cast batches, as long as nothing writes meanwhile, they return references into the arrays.
+	 */
+	class FURY_API TransformSystem
+	{
+	public:
+
+		typedef std::shared_ptr<TransformSystem> Ptr;
+
+		// every scenenode registers here, created by the first scenenode.
+		static Ptr Active;
+
+		static Ptr Create();
+
+		static const unsigned int INVALID_HANDLE;
+
+	protected:
+
+		static const unsigned char LOCAL_DIRTY = 0x01;
+
+		static const unsigned char WORLD_CHANGED = 0x02;
+
+		// no non-uniform scale, so the inverse is a transpose.
+		static const unsigned char LOCAL_UNIFORM = 0x10;
+
+		static const unsigned char WORLD_UNIFORM = 0x20;
+
+		// static transforms are computed once more after SetStatic, then frozen.
+		// Update skips frozen ones, their childs follow the baked world matrix.
+		static const unsigned char STATIC = 0x40;
+
+		static const unsigned char FROZEN = 0x80;
+
+		// inverses are computed by the first getter after a change, 
+		// it marks the slot busy so other threads wait for it instead of computing it again.
+		static const unsigned char INVERT_DIRTY = 0;
+
+		static const unsigned char INVERT_BUSY = 1;
+
+		static const unsigned char INVERT_CLEAN = 2;
+
+		// kept apart from m_Flags, so getters never write bytes other getters read without atomics.
+		// only copied by the main thread, while no getter runs.
+		struct InvertState
+		{
+			std::atomic<unsigned char> local;
+
+			std::atomic<unsigned char> world;
+
+			InvertState() : local(INVERT_DIRTY), world(INVERT_DIRTY) {}
+
+			InvertState(const InvertState &other) : 
+				local(other.local.load(std::memory_order_relaxed)), world(other.world.load(std::memory_order_relaxed)) {}
+
+			InvertState &operator = (const InvertState &other)
+			{
+				local.store(other.local.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				world.store(other.world.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				return *this;
+			}
+		};
+
+		// handle -> index, INVALID_HANDLE for free handles.
+		std::vector<unsigned int> m_Indices;
+
+		std::vector<unsigned int> m_FreeHandles;
+
+		// everything below is indexed by index.
+
+		std::vector<unsigned int> m_Handles;
+
+		std::vector<SceneNode*> m_Owners;
+
+		std::vector<unsigned int> m_ParentHandles;
+
+		// valid while m_OrderDirty is false.
+		std::vector<unsigned int> m_ParentIndices;
+
+		std::vector<unsigned char> m_Flags;
+
+		mutable std::vector<InvertState> m_InvertStates;
+
+		std::vector<Vector4> m_LocalPositions;
+
+		std::vector<Quaternion> m_LocalRotations;
+
+		std::vector<Vector4> m_LocalScales;
+
+		std::vector<Matrix4> m_LocalMatrices;
+
+		mutable std::vector<Matrix4> m_InvertLocalMatrices;
+
+		std::vector<Matrix4> m_WorldMatrices;
+
+		mutable std::vector<Matrix4> m_InvertWorldMatrices;
+
+		std::vector<Vector4> m_WorldPositions;
+
+		std::vector<Quaternion> m_WorldRotations;
+
+		std::vector<Vector4> m_WorldScales;
+
+		// first index of each depth level, plus the end.
+		std::vector<unsigned int> m_LevelStarts;
+
+		bool m_OrderDirty = false;
+
+		unsigned int m_DirtyCount = 0;
+
+		// levels with less transforms are updated on the calling thread.
+		unsigned int m_ParallelThreshold = 4096;
+
+	public:
+
+		TransformSystem();
+
+		unsigned int Add(SceneNode *owner);
+
+		void Remove(unsigned int handle);
+
+		void SetParent(unsigned int handle, unsigned int parentHandle);
+
+		unsigned int GetCount() const;
+
+		unsigned int GetParallelThreshold() const;
+
+		void SetParallelThreshold(unsigned int threshold);
+
+		bool GetDirty(unsigned int handle) const;
+
+		void SetDirty(unsigned int handle);
+
+		bool GetStatic(unsigned int handle) const;
+
+		// local changes of a frozen transform wait until it's not static anymore.
+		void SetStatic(unsigned int handle, bool isStatic);
+
+		// static and baked.
+		bool GetFrozen(unsigned int handle) const;
+
+		Vector4 GetLocalPosition(unsigned int handle) const;
+
+		void SetLocalPosition(unsigned int handle, Vector4 position);
+
+		Quaternion GetLocalRotation(unsigned int handle) const;
+
+		void SetLocalRotation(unsigned int handle, Quaternion rotation);
+
+		Vector4 GetLocalScale(unsigned int handle) const;
+
+		void SetLocalScale(unsigned int handle, Vector4 scale);
+
+		const Matrix4 &GetLocalMatrix(unsigned int handle) const;
+
+		// inverse getters fill their cache on first use after a change, a filled cache is read without locking.
+		// like the other getters they may be called from several threads at once, 
+		// but not while setters, Update, Add or Remove run.
+		const Matrix4 &GetInvertLocalMatrix(unsigned int handle) const;
+
+		const Matrix4 &GetWorldMatrix(unsigned int handle) const;
+
+		const Matrix4 &GetInvertWorldMatrix(unsigned int handle) const;
+
+		Vector4 GetWorldPosition(unsigned int handle) const;
+
+		Quaternion GetWorldRotation(unsigned int handle) const;
+
+		Vector4 GetWorldScale(unsigned int handle) const;
+
+		// recompute one transform from it's parent's current world matrix, childs are left untouched.
+		// frozen transforms are left untouched too.
+		void Compose(unsigned int handle);
+
+		// recompute dirty transforms and all their descendants, and their scenenodes' aabbs.
+		// then changed scenenodes are handed to their scene managers in one batch each, 
+		// and OnTransformChange is emitted once per scenenode, parents first.
+		// call it from the main thread, returns number of changed transforms.
+		unsigned int Update();
+
+	protected:
+
+		void SortByDepth();
+
+		void ComposeIndex(unsigned int index, unsigned int parentIndex);
+
+		// recompute transforms in [start, end) of one level.
+		void UpdateRange(unsigned int start, unsigned int end);
+
+		// fills inverse from matrix if state is dirty, waits if another thread is filling it.
+		static const Matrix4 &GetInverse(std::atomic<unsigned char> &state, const Matrix4 &matrix, Matrix4 &inverse, bool rigid);
+
+		template<class Type>
+		static void Permute(std::vector<Type> &values, const std::vector<unsigned int> &order);
+	};
+
+	template<class Type>
+	void TransformSystem::Permute(std::vector<Type> &values, const std::vector<unsigned int> &order)
+	{
+		std::vector<Type> sorted;
+		sorted.reserve(values.size());
+		for (auto index : order)
+			sorted.push_back(values[index]);
+		values.swap(sorted);
+	}
+}
+
+#endif // _FURY_TRANSFORM_SYSTEM_H_
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <limits>
+
+#include "Fury/Ray.h"
+#include "Fury/TriangleBVH.h"
+
+namespace fury
+{
+	TriangleBVH::Ptr TriangleBVH::Create(const std::vector<float> &positions, const std::vector<unsigned int> &indices, unsigned int leafSize)
+	{
+		return std::make_shared<TriangleBVH>(positions, indices, leafSize);
+	}
+
+	TriangleBVH::TriangleBVH(const std::vector<float> &positions, const std::vector<unsigned int> &indices, unsigned int leafSize) :
+		m_LeafSize(std::max(leafSize, 1u))
+	{
+		unsigned int vertexCount = positions.size() / 3;
+		unsigned int triangleCount = indices.size() / 3;
+
+		std::vector<BuildTriangle> triangles;
+		triangles.reserve(triangleCount);
+
+		for (unsigned int i = 0; i < triangleCount; i++)
+		{
+			unsigned int ids[3] = { indices[i * 3], indices[i * 3 + 1], indices[i * 3 + 2] };
+			if (ids[0] >= vertexCount || ids[1] >= vertexCount || ids[2] >= vertexCount)
+				continue;
+
+			BuildTriangle triangle;
+			for (int j = 0; j < 3; j++)
+			{
+				triangle.min[j] = std::min(positions[ids[0] * 3 + j], std::min(positions[ids[1] * 3 + j], positions[ids[2] * 3 + j]));
+				triangle.max[j] = std::max(positions[ids[0] * 3 + j], std::max(positions[ids[1] * 3 + j], positions[ids[2] * 3 + j]));
+				triangle.center[j] = (triangle.min[j] + triangle.max[j]) * 0.5f;
+			}
+			triangle.index = i;
+
+			triangles.push_back(triangle);
+		}
+
+		if (triangles.empty())
+			return;
+
+		m_TreeNodes.reserve(triangles.size() * 2 / m_LeafSize + 1);
+		BuildNode(triangles, 0, triangles.size());
+
+		m_Triangles.resize(triangles.size());
+		m_Vertices.resize(triangles.size() * 9);
+
+		for (unsigned int i = 0; i < triangles.size(); i++)
+		{
+			unsigned int index = triangles[i].index;
+			m_Triangles[i] = index;
+
+			for (int j = 0; j < 3; j++)
+			{
+				unsigned int vertex = indices[index * 3 + j];
+				m_Vertices[i * 9 + j * 3] = positions[vertex * 3];
+				m_Vertices[i * 9 + j * 3 + 1] = positions[vertex * 3 + 1];
+				m_Vertices[i * 9 + j * 3 + 2] = positions[vertex * 3 + 2];
+			}
+		}
+	}
+
+	bool TriangleBVH::RayCast(const Ray &ray, float &distance, unsigned int &triangle) const
+	{
+		if (m_TreeNodes.empty())
+			return false;
+
+		Vector4 rayOrigin = ray.GetOrigin();
+		Vector4 rayDirection = ray.GetDirection();
+
+		// FLT_MAX instead of inf, so 0 * inverse never gives NaN.
+		float origin[3] = { rayOrigin.x, rayOrigin.y, rayOrigin.z };
+		float dir[3] = { rayDirection.x, rayDirection.y, rayDirection.z };
+		float invDirection[3];
+		for (int i = 0; i < 3; i++)
+			invDirection[i] = dir[i] != 0.0f ? 1.0f / dir[i] : std::numeric_limits<float>::max();
+
+		float closest = ray.GetMaxDistance();
+		bool found = false;
+
+		float entry;
+		if (!IntersectNode(m_TreeNodes[0], origin, invDirection, closest, entry))
+			return false;
+
+		// nodes with their entry distances, nearer child is popped first.
+		std::vector<std::pair<unsigned int, float>> possibleNodes;
+		possibleNodes.reserve(64);
+		possibleNodes.push_back(std::make_pair(0u, entry));
+
+		while (!possibleNodes.empty())
+		{
+			std::pair<unsigned int, float> current = possibleNodes.back();
+			possibleNodes.pop_back();
+
+			// a closer hit was found after this node was pushed.
+			if (current.second > closest)
+				continue;
+
+			const TreeNode &treeNode = m_TreeNodes[current.first];
+
+			if (treeNode.count > 0)
+			{
+				for (unsigned int i = treeNode.offset; i < treeNode.offset + treeNode.count; i++)
+				{
+					const float *v = &m_Vertices[i * 9];
+
+					float hitDistance;
+					if (ray.Intersects(Vector4(v[0], v[1], v[2]), Vector4(v[3], v[4], v[5]), Vector4(v[6], v[7], v[8]), hitDistance) &&
+						hitDistance < closest)
+					{
+						closest = hitDistance;
+						triangle = m_Triangles[i];
+						found = true;
+					}
+				}
+				continue;
+			}
+
+			unsigned int left = current.first + 1, right = treeNode.offset;
+
+			float leftDistance, rightDistance;
+			bool leftHit = IntersectNode(m_TreeNodes[left], origin, invDirection, closest, leftDistance);
+			bool rightHit = IntersectNode(m_TreeNodes[right], origin, invDirection, closest, rightDistance);
+
+			if (leftHit && rightHit)
+			{
+				if (leftDistance < rightDistance)
+				{
+					possibleNodes.push_back(std::make_pair(right, rightDistance));
+					possibleNodes.push_back(std::make_pair(left, leftDistance));
+				}
+				else
+				{
+					possibleNodes.push_back(std::make_pair(left, leftDistance));
+					possibleNodes.push_back(std::make_pair(right, rightDistance));
+				}
+			}
+			else if (leftHit)
+			{
+				possibleNodes.push_back(std::make_pair(left, leftDistance));
+			}
+			else if (rightHit)
+			{
+				possibleNodes.push_back(std::make_pair(right, rightDistance));
+			}
+		}
+
+		if (found)
+			distance = closest;
+
+		return found;
+	}
+
+	unsigned int TriangleBVH::GetTriangleCount() const
+	{
+		return m_Triangles.size();
+	}
+
+	unsigned int TriangleBVH::GetTreeNodeCount() const
+	{
+		return m_TreeNodes.size();
+	}
+
+	void TriangleBVH::BuildNode(std::vector<BuildTriangle> &triangles, unsigned int start, unsigned int end)
+	{
+		unsigned int index = m_TreeNodes.size();
+
+		TreeNode treeNode;
+		for (int i = 0; i < 3; i++)
+		{
+			treeNode.min[i] = std::numeric_limits<float>::max();
+			treeNode.max[i] = -std::numeric_limits<float>::max();
+		}
+
+		float centerMin[3], centerMax[3];
+		std::copy(treeNode.min, treeNode.min + 3, centerMin);
+		std::copy(treeNode.max, treeNode.max + 3, centerMax);
+
+		for (unsigned int i = start; i < end; i++)
+		{
+			const BuildTriangle &triangle = triangles[i];
+			for (int j = 0; j < 3; j++)
+			{
+				treeNode.min[j] = std::min(treeNode.min[j], triangle.min[j]);
+				treeNode.max[j] = std::max(treeNode.max[j], triangle.max[j]);
+				centerMin[j] = std::min(centerMin[j], triangle.center[j]);
+				centerMax[j] = std::max(centerMax[j], triangle.center[j]);
+			}
+		}
+
+		treeNode.offset = start;
+		treeNode.count = end - start;
+		m_TreeNodes.push_back(treeNode);
+
+		if (treeNode.count <= m_LeafSize)
+			return;
+
+		// median split on the longest axis of triangle centers.
+		int axis = 0;
+		for (int i = 1; i < 3; i++)
+		{
+			if (centerMax[i] - centerMin[i] > centerMax[axis] - centerMin[axis])
+				axis = i;
+		}
+
+		// all centers at one point, splitting won't help.
+		if (centerMax[axis] - centerMin[axis] <= 0.0f)
+			return;
+
+		unsigned int mid = start + (end - start) / 2;
+		std::nth_element(triangles.begin() + start, triangles.begin() + mid, triangles.begin() + end,
+			[axis](const BuildTriangle &a, const BuildTriangle &b)
+		{
+			return a.center[axis] < b.center[axis];
+		});
+
+		// m_TreeNodes grows while building childs, don't keep references.
+		BuildNode(triangles, start, mid);
+		unsigned int right = m_TreeNodes.size();
+		BuildNode(triangles, mid, end);
+
+		m_TreeNodes[index].offset = right;
+		m_TreeNodes[index].count = 0;
+	}
+
+	bool TriangleBVH::IntersectNode(const TreeNode &treeNode, const float *origin, const float *invDirection, float maxDistance, float &distance) const
+	{
+		float near = 0.0f, far = maxDistance;
+
+		for (int i = 0; i < 3; i++)
+		{
+			float t0 = (treeNode.min[i] - origin[i]) * invDirection[i];
+			float t1 = (treeNode.max[i] - origin[i]) * invDirection[i];
+			if (t0 > t1)
+				std::swap(t0, t1);
+
+			near = std::max(near, t0);
+			far = std::min(far, t1);
+		}
+
+		distance = near;
+		return near <= far;
+	}
+}
\ No newline at end of file
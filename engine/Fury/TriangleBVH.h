@@ -0,0 +1,78 @@
+#ifndef _FURY_TRIANGLE_BVH_H_
+#define _FURY_TRIANGLE_BVH_H_
+
+#include <vector>
+#include <memory>
+
+#include "Fury/Macros.h"
+
+namespace fury
+{
+	class Ray;
+
+	/**
+	 *	Bounding volume hierarchy over a mesh's triangles, for ray casts in mesh space.
+	 *
+	 *	Tree nodes are stored depth first, so the left child of a node follows it directly.
+	 *	Leaves keep a copy of their triangles' vertices, ray tests never touch the mesh.
+	 */
+	class FURY_API TriangleBVH
+	{
+	public:
+
+		typedef std::shared_ptr<TriangleBVH> Ptr;
+
+		// indices are 3 per triangle, into positions which are 3 floats per vertex.
+		static Ptr Create(const std::vector<float> &positions, const std::vector<unsigned int> &indices, unsigned int leafSize = 4);
+
+	protected:
+
+		struct TreeNode
+		{
+			float min[3], max[3];
+
+			// right child of internal node, triangle start of leaf node.
+			unsigned int offset;
+
+			// 0 for internal node.
+			unsigned int count;
+		};
+
+		struct BuildTriangle
+		{
+			float min[3], max[3], center[3];
+
+			unsigned int index;
+		};
+
+		unsigned int m_LeafSize;
+
+		std::vector<TreeNode> m_TreeNodes;
+
+		// 9 floats per triangle, in leaf order.
+		std::vector<float> m_Vertices;
+
+		// triangle index in the source index buffer, in leaf order.
+		std::vector<unsigned int> m_Triangles;
+
+	public:
+
+		TriangleBVH(const std::vector<float> &positions, const std::vector<unsigned int> &indices, unsigned int leafSize);
+
+		// nearest triangle hit by ray within it's max distance.
+		bool RayCast(const Ray &ray, float &distance, unsigned int &triangle) const;
+
+		unsigned int GetTriangleCount() const;
+
+		unsigned int GetTreeNodeCount() const;
+
+	protected:
+
+		void BuildNode(std::vector<BuildTriangle> &triangles, unsigned int start, unsigned int end);
+
+		// distance where ray enters the node, false if it misses or enters beyond maxDistance.
+		bool IntersectNode(const TreeNode &treeNode, const float *origin, const float *invDirection, float maxDistance, float &distance) const;
+	};
+}
+
+#endif // _FURY_TRIANGLE_BVH_H_
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include <algorithm>
+
+#include "Fury/Camera.h"
+#include "Fury/DetailCuller.h"
+#include "Fury/Frustum.h"
+#include "Fury/Light.h"
+#include "Fury/MeshRender.h"
+#include "Fury/RenderQuery.h"
+#include "Fury/SceneNode.h"
+#include "Fury/VisibilityCache.h"
+
+namespace fury
+{
+	VisibilityCache::Ptr VisibilityCache::Create(unsigned int maxPatchSize)
+	{
+		return std::make_shared<VisibilityCache>(maxPatchSize);
+	}
+
+	VisibilityCache::VisibilityCache(unsigned int maxPatchSize) : m_MaxPatchSize(maxPatchSize)
+	{
+
+	}
+
+	bool VisibilityCache::GetRenderQuery(const std::shared_ptr<SceneManager> &sceneManager, const std::shared_ptr<SceneNode> &camera,
+		std::shared_ptr<RenderQuery> &renderQuery, const BuildFunc &buildFunc)
+	{
+		auto cameraPtr = camera->GetComponent<Camera>();
+		Matrix4 projectionMatrix = cameraPtr->GetProjectionMatrix();
+		Matrix4 worldMatrix = camera->GetWorldMatrix();
+		Frustum frustum = cameraPtr->GetFrustum();
+
+		// camera's draw distances and min screen sizes apply to patches and default rebuilds.
+		DetailCuller lightCuller(frustum, *cameraPtr, (unsigned int)SceneNodeCategory::LIGHT);
+		DetailCuller renderableCuller(frustum, *cameraPtr, (unsigned int)SceneNodeCategory::RENDERABLE);
+
+		float drawDistances[2] = { cameraPtr->GetDrawDistance(SceneNodeCategory::LIGHT), cameraPtr->GetDrawDistance(SceneNodeCategory::RENDERABLE) };
+		float minScreenSizes[2] = { cameraPtr->GetMinScreenSize(SceneNodeCategory::LIGHT), cameraPtr->GetMinScreenSize(SceneNodeCategory::RENDERABLE) };
+
+		auto it = m_Entries.find(camera.get());
+		if (it == m_Entries.end() || it->second.camera.lock() != camera)
+		{
+			// drop entries of destoried cameras before adding a new one.
+			for (auto entryIt = m_Entries.begin(); entryIt != m_Entries.end();)
+			{
+				if (entryIt->second.camera.expired())
+					entryIt = m_Entries.erase(entryIt);
+				else
+					++entryIt;
+			}
+
+			CacheEntry &entry = m_Entries[camera.get()];
+			entry = CacheEntry();
+			entry.camera = camera;
+			entry.renderQuery = RenderQuery::Create();
+
+			it = m_Entries.find(camera.get());
+		}
+
+		CacheEntry &entry = it->second;
+		entry.renderQuery->lodCamera = cameraPtr;
+
+		bool sameView = entry.sceneManager.lock() == sceneManager &&
+			entry.projectionMatrix == projectionMatrix && entry.worldMatrix == worldMatrix &&
+			std::equal(drawDistances, drawDistances + 2, entry.drawDistances) &&
+			std::equal(minScreenSizes, minScreenSizes + 2, entry.minScreenSizes);
+
+		bool changed = true;
+		if (sameView && entry.epoch == sceneManager->GetEpoch())
+			changed = false;
+		else if (!sameView || !PatchRenderQuery(sceneManager, lightCuller, renderableCuller, entry))
+		{
+			if (buildFunc != nullptr)
+				buildFunc(frustum, entry.renderQuery);
+			else
+				BuildRenderQuery(sceneManager, lightCuller, renderableCuller, *entry.renderQuery);
+		}
+
+		entry.sceneManager = sceneManager;
+		entry.projectionMatrix = projectionMatrix;
+		entry.worldMatrix = worldMatrix;
+		std::copy(drawDistances, drawDistances + 2, entry.drawDistances);
+		std::copy(minScreenSizes, minScreenSizes + 2, entry.minScreenSizes);
+		entry.epoch = sceneManager->GetEpoch();
+
+		renderQuery = entry.renderQuery;
+		return changed;
+	}
+
+	void VisibilityCache::Invalidate()
+	{
+		m_Entries.clear();
+	}
+
+	void VisibilityCache::Invalidate(const std::shared_ptr<SceneNode> &camera)
+	{
+		m_Entries.erase(camera.get());
+	}
+
+	unsigned int VisibilityCache::GetMaxPatchSize() const
+	{
+		return m_MaxPatchSize;
+	}
+
+	void VisibilityCache::SetMaxPatchSize(unsigned int size)
+	{
+		m_MaxPatchSize = size;
+	}
+
+	void VisibilityCache::BuildRenderQuery(const std::shared_ptr<SceneManager> &sceneManager, const DetailCuller &lightCuller, 
+		const DetailCuller &renderableCuller, RenderQuery &renderQuery)
+	{
+		renderQuery.Clear();
+
+		std::vector<const Collidable*> colliders = { &lightCuller, &renderableCuller };
+		sceneManager->WalkSceneViews(colliders, [&](const std::shared_ptr<SceneNode> &sceneNode, uint32_t viewMask)
+		{
+			AddSceneNode(sceneNode, (viewMask & 1) != 0, (viewMask & 2) != 0, renderQuery);
+		}, (unsigned int)SceneNodeCategory::LIGHT | (unsigned int)SceneNodeCategory::RENDERABLE);
+	}
+
+	bool VisibilityCache::PatchRenderQuery(const std::shared_ptr<SceneManager> &sceneManager, const DetailCuller &lightCuller, 
+		const DetailCuller &renderableCuller, CacheEntry &entry)
+	{
+		if (!sceneManager->GetChangesSince(entry.epoch, m_Changes) || m_Changes.size() > m_MaxPatchSize)
+			return false;
+
+		// the last change of a scenenode decides if it's still in the scene.
+		std::unordered_map<SceneNode*, unsigned int> lastChanges;
+		for (unsigned int i = 0; i < m_Changes.size(); i++)
+			lastChanges[m_Changes[i].sceneNode] = i;
+
+		auto isChanged = [&](const std::shared_ptr<SceneNode> &sceneNode)
+		{
+			return lastChanges.find(sceneNode.get()) != lastChanges.end();
+		};
+
+		auto isUnitChanged = [&](const RenderUnit &unit)
+		{
+			return isChanged(unit.node);
+		};
+
+		RenderQuery &query = *entry.renderQuery;
+		query.opaqueUnits.erase(std::remove_if(query.opaqueUnits.begin(), query.opaqueUnits.end(), isUnitChanged), query.opaqueUnits.end());
+		query.transparentUnits.erase(std::remove_if(query.transparentUnits.begin(), query.transparentUnits.end(), isUnitChanged), query.transparentUnits.end());
+		query.renderableNodes.erase(std::remove_if(query.renderableNodes.begin(), query.renderableNodes.end(), isChanged), query.renderableNodes.end());
+		query.lightNodes.erase(std::remove_if(query.lightNodes.begin(), query.lightNodes.end(), isChanged), query.lightNodes.end());
+
+		// scenenodes still in the scene are kept alive by the scene manager.
+		for (unsigned int i = 0; i < m_Changes.size(); i++)
+		{
+			const auto &change = m_Changes[i];
+			if (change.removed || lastChanges[change.sceneNode] != i)
+				continue;
+
+			SceneNode::Ptr sceneNode = change.sceneNode->shared_from_this();
+			BoxBounds aabb = sceneNode->GetWorldAABB();
+			AddSceneNode(sceneNode, lightCuller.IsInsideFast(aabb), renderableCuller.IsInsideFast(aabb), query);
+		}
+
+		return true;
+	}
+
+	void VisibilityCache::AddSceneNode(const std::shared_ptr<SceneNode> &sceneNode, bool lightVisible, bool renderableVisible, RenderQuery &renderQuery)
+	{
+		if (lightVisible && sceneNode->GetComponent<Light>() != nullptr)
+			renderQuery.AddLight(sceneNode);
+
+		if (renderableVisible)
+		{
+			auto render = sceneNode->GetComponent<MeshRender>();
+			if (render != nullptr && render->GetRenderable())
+				renderQuery.AddRenderable(sceneNode);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef _FURY_VISIBILITY_CACHE_H_
+#define _FURY_VISIBILITY_CACHE_H_
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+
+#include "Fury/Matrix4.h"
+#include "Fury/SceneManager.h"
+
+namespace fury
+{
+	class DetailCuller;
+
+	class RenderQuery;
+
+	/**
+	 *	Keeps the last RenderQuery of each camera.
+	 *
+	 *	A query is reused as is if the camera's frustum, draw distances and min screen sizes 
+	 *	and the scene manager's epoch didn't change,
+	 *	when only a few scenenodes changed, they are removed from the query and culled again one by one.
+	 *	Otherwise the query is rebuilt from scratch.
+	 *	Like Pipeline::CullViews, lights and renderables are culled by their own category's thresholds.
+	 *
+	 *	Only insert/update/remove of scenenodes are tracked,
+	 *	call Invalidate after changing components of visible scenenodes.
+	 */
+	class FURY_API VisibilityCache
+	{
+	public:
+
+		typedef std::shared_ptr<VisibilityCache> Ptr;
+
+		// fills renderQuery with what's visible in collider, replaces SceneManager::GetRenderQuery on rebuilds.
+		typedef std::function<void(const Collidable&, const std::shared_ptr<RenderQuery>&)> BuildFunc;
+
+		static Ptr Create(unsigned int maxPatchSize = 64);
+
+	protected:
+
+		struct CacheEntry
+		{
+			std::weak_ptr<SceneNode> camera;
+
+			std::weak_ptr<SceneManager> sceneManager;
+
+			Matrix4 projectionMatrix;
+
+			Matrix4 worldMatrix;
+
+			// camera's thresholds of lights, then renderables.
+			float drawDistances[2] = { 0.0f, 0.0f };
+
+			float minScreenSizes[2] = { 0.0f, 0.0f };
+
+			uint64_t epoch = 0;
+
+			std::shared_ptr<RenderQuery> renderQuery;
+		};
+
+		std::unordered_map<SceneNode*, CacheEntry> m_Entries;
+
+		// more changes than this rebuilds the query.
+		unsigned int m_MaxPatchSize;
+
+		std::vector<SceneManager::SceneChange> m_Changes;
+
+	public:
+
+		VisibilityCache(unsigned int maxPatchSize);
+
+		// returns true if renderQuery changed since last call with this camera, so it needs sorting again.
+		// renderQuery is owned by the cache, don't modify it.
+		// buildFunc lets callers cull other views in the same walk when the query is rebuilt.
+		bool GetRenderQuery(const std::shared_ptr<SceneManager> &sceneManager, const std::shared_ptr<SceneNode> &camera,
+			std::shared_ptr<RenderQuery> &renderQuery, const BuildFunc &buildFunc = nullptr);
+
+		void Invalidate();
+
+		void Invalidate(const std::shared_ptr<SceneNode> &camera);
+
+		unsigned int GetMaxPatchSize() const;
+
+		void SetMaxPatchSize(unsigned int size);
+
+	protected:
+
+		void BuildRenderQuery(const std::shared_ptr<SceneManager> &sceneManager, const DetailCuller &lightCuller, 
+			const DetailCuller &renderableCuller, RenderQuery &renderQuery);
+
+		// re-cull changed scenenodes only, returns false if the query should be rebuilt.
+		bool PatchRenderQuery(const std::shared_ptr<SceneManager> &sceneManager, const DetailCuller &lightCuller, 
+			const DetailCuller &renderableCuller, CacheEntry &entry);
+
+		static void AddSceneNode(const std::shared_ptr<SceneNode> &sceneNode, bool lightVisible, bool renderableVisible, RenderQuery &renderQuery);
+	};
+}
+
+#endif // _FURY_VISIBILITY_CACHE_H_
\ No newline at end of file
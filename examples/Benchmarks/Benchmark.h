@@ -0,0 +1,55 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <Fury/Fury.h>
+
+using namespace std;
+using namespace fury;
+
+// shared by the benchmark executables, they run without a window or gl context.
+namespace benchmark
+{
+	inline void Initialize(int numThreads)
+	{
+		Log<0>::Initialize(LogLevel::EROR, (const char*)nullptr, true, Formatter::Simple, false);
+
+		ThreadUtil::Initialize(std::move(numThreads));
+		ThreadUtil::Instance()->SetMainThread();
+	}
+
+	// command line argument at index as a count, or fallback.
+	inline unsigned int GetCount(int argc, char *argv[], int index, unsigned int fallback)
+	{
+		return argc > index ? (unsigned int)std::atoi(argv[index]) : fallback;
+	}
+
+	inline float Random(float min, float max)
+	{
+		return min + (max - min) * (float)std::rand() / (float)RAND_MAX;
+	}
+
+	// average milliseconds of func over repeat runs.
+	template<class Func>
+	double Measure(unsigned int repeat, Func &&func)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < repeat; i++)
+			func();
+		auto end = std::chrono::high_resolution_clock::now();
+
+		return std::chrono::duration<double, std::milli>(end - start).count() / repeat;
+	}
+
+	inline void Print(const std::string &name, double ms)
+	{
+		std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(3) << ms << " ms" << std::endl;
+	}
+}
+
+#endif // _BENCHMARK_H_
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <vector>
+
+#include "Benchmark.h"
+
+// frustum culling of static objects: scene managers, the batched aabb test and the inlined tree visit.
+// usage: CullingBenchmark [objectCount] [repeat]
+
+static const float WORLD_EXTENT = 500.0f;
+
+static Frustum CreateFrustum()
+{
+	// at the origin looking down -z, sees roughly a tenth of the world.
+	Frustum frustum;
+	frustum.Setup(60.0f * MathUtil::DegToRad, 16.0f / 9.0f, 0.1f, 600.0f);
+	return frustum;
+}
+
+static std::vector<BoxBounds> CreateBounds(unsigned int objectCount)
+{
+	std::srand(1);
+
+	std::vector<BoxBounds> bounds(objectCount);
+	for (auto &aabb : bounds)
+	{
+		float size = benchmark::Random(0.5f, 4.0f);
+		Vector4 center(benchmark::Random(-WORLD_EXTENT, WORLD_EXTENT),
+			benchmark::Random(-WORLD_EXTENT, WORLD_EXTENT), benchmark::Random(-WORLD_EXTENT, WORLD_EXTENT));
+		aabb.SetMinMax(center - Vector4(size, 0.0f), center + Vector4(size, 0.0f));
+	}
+
+	return bounds;
+}
+
+static Scene::Ptr CreateScene(const std::string &name, const SceneManager::Ptr &sceneManager, const std::vector<BoxBounds> &bounds)
+{
+	auto scene = Scene::Create(name, "", sceneManager);
+	auto root = scene->GetRootNode();
+
+	for (auto &aabb : bounds)
+	{
+		Vector4 center = aabb.GetCenter();
+		auto node = SceneNode::Create("object");
+		node->SetModelAABB(BoxBounds(aabb.GetMin() - center, aabb.GetMax() - center));
+		node->SetLocalPosition(center);
+		root->AddChild(node);
+	}
+
+	scene->FlushTransforms();
+	sceneManager->AddSceneNodeRecursively(root);
+	sceneManager->Flush();
+
+	return scene;
+}
+
+// LooseOcTree against OcTree, both through the virtual WalkScene.
+static void CompareSceneManagers(const std::vector<BoxBounds> &bounds, const Frustum &frustum, unsigned int repeat)
+{
+	Vector4 worldMin(-WORLD_EXTENT - 10.0f), worldMax(WORLD_EXTENT + 10.0f);
+
+	SceneManager::Ptr sceneManagers[] =
+	{
+		OcTree::Create(worldMin, worldMax, 6),
+		LooseOcTree::Create(worldMin, worldMax, 6)
+	};
+	std::string names[] = { "OcTree::WalkScene", "LooseOcTree::WalkScene" };
+
+	for (int i = 0; i < 2; i++)
+	{
+		auto scene = CreateScene(names[i], sceneManagers[i], bounds);
+
+		unsigned int visibleCount = 0;
+		double ms = benchmark::Measure(repeat, [&]()
+		{
+			visibleCount = 0;
+			sceneManagers[i]->WalkScene(frustum, [&](const SceneNode::Ptr &sceneNode)
+			{
+				visibleCount++;
+			});
+		});
+
+		benchmark::Print(names[i] + " (" + std::to_string(visibleCount) + " visible)", ms);
+
+		scene->GetRootNode()->RemoveAllChilds();
+		sceneManagers[i]->Clear();
+	}
+}
+
+// the structure of arrays kernel against one Frustum::IsInside call per aabb.
+static void CompareBoundsTests(const std::vector<BoxBounds> &bounds, const Frustum &frustum, unsigned int repeat)
+{
+	BoxBoundsArray boundsArray;
+	boundsArray.Reserve(bounds.size());
+	for (auto &aabb : bounds)
+		boundsArray.Add(aabb);
+
+	unsigned int count = bounds.size();
+	std::vector<unsigned char> results(count);
+
+	unsigned int scalarCount = 0;
+	double scalarMs = benchmark::Measure(repeat, [&]()
+	{
+		scalarCount = 0;
+		for (auto &aabb : bounds)
+		{
+			if (frustum.IsInside(aabb) != Side::OUT)
+				scalarCount++;
+		}
+	});
+
+	unsigned int batchCount = 0;
+	double batchMs = benchmark::Measure(repeat, [&]()
+	{
+		frustum.IsInsideFastBatch(boundsArray, 0, count, &results[0]);
+
+		batchCount = 0;
+		for (auto result : results)
+			batchCount += result;
+	});
+
+	benchmark::Print("Frustum::IsInside (" + std::to_string(scalarCount) + " visible)", scalarMs);
+	benchmark::Print("Frustum::IsInsideFastBatch (" + std::to_string(batchCount) + " visible)", batchMs);
+}
+
+// cost per visible scenenode of the std::function callback against the inlined visitor.
+static void CompareVisit(const std::vector<BoxBounds> &bounds, const Frustum &frustum, unsigned int repeat)
+{
+	auto ocTree = OcTree::Create(Vector4(-WORLD_EXTENT - 10.0f), Vector4(WORLD_EXTENT + 10.0f), 6);
+	auto scene = CreateScene("Visit", ocTree, bounds);
+
+	unsigned int walkCount = 0;
+	double walkMs = benchmark::Measure(repeat, [&]()
+	{
+		walkCount = 0;
+		ocTree->WalkScene(frustum, [&](const SceneNode::Ptr &sceneNode)
+		{
+			walkCount++;
+		});
+	});
+
+	unsigned int visitCount = 0;
+	double visitMs = benchmark::Measure(repeat, [&]()
+	{
+		visitCount = 0;
+		ocTree->Visit(frustum, [&](const SceneNode::Ptr &sceneNode)
+		{
+			visitCount++;
+		});
+	});
+
+	// in nanoseconds, the totals are printed above.
+	std::cout << std::left << std::setw(48) << "OcTree::WalkScene per visible" << std::right << std::fixed << std::setprecision(1)
+		<< walkMs * 1e6 / std::max(walkCount, 1u) << " ns" << std::endl;
+	std::cout << std::left << std::setw(48) << "OcTree::Visit per visible" << std::right << std::fixed << std::setprecision(1)
+		<< visitMs * 1e6 / std::max(visitCount, 1u) << " ns" << std::endl;
+
+	scene->GetRootNode()->RemoveAllChilds();
+	ocTree->Clear();
+}
+
+int main(int argc, char *argv[])
+{
+	benchmark::Initialize(2);
+
+	unsigned int objectCount = benchmark::GetCount(argc, argv, 1, 50000);
+	unsigned int repeat = benchmark::GetCount(argc, argv, 2, 100);
+
+	std::cout << objectCount << " static objects, average of " << repeat << " runs:" << std::endl;
+
+	auto bounds = CreateBounds(objectCount);
+	auto frustum = CreateFrustum();
+
+	CompareSceneManagers(bounds, frustum, repeat);
+	CompareBoundsTests(bounds, frustum, repeat);
+	CompareVisit(bounds, frustum, repeat);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include <vector>
+
+#include "Benchmark.h"
+
+// moves every object each frame, then flushes transforms into the scene manager.
+// usage: MovingObjects [objectCount] [frameCount]
+
+static const float WORLD_EXTENT = 500.0f;
+
+struct Mover
+{
+	SceneNode::Ptr node;
+
+	Vector4 position;
+
+	Vector4 velocity;
+};
+
+static void Run(const std::string &name, const SceneManager::Ptr &sceneManager, unsigned int objectCount, unsigned int frameCount)
+{
+	auto scene = Scene::Create(name, "", sceneManager);
+	auto root = scene->GetRootNode();
+
+	// same objects for every scene manager.
+	std::srand(1);
+
+	std::vector<Mover> movers(objectCount);
+	for (auto &mover : movers)
+	{
+		float size = benchmark::Random(0.5f, 2.0f);
+		mover.position = Vector4(benchmark::Random(-WORLD_EXTENT, WORLD_EXTENT),
+			benchmark::Random(-WORLD_EXTENT, WORLD_EXTENT), benchmark::Random(-WORLD_EXTENT, WORLD_EXTENT));
+		mover.velocity = Vector4(benchmark::Random(-2.0f, 2.0f), benchmark::Random(-2.0f, 2.0f), benchmark::Random(-2.0f, 2.0f));
+
+		mover.node = SceneNode::Create("mover");
+		mover.node->SetModelAABB(BoxBounds(Vector4(-size), Vector4(size)));
+		mover.node->SetLocalPosition(mover.position);
+		root->AddChild(mover.node);
+	}
+
+	scene->FlushTransforms();
+	sceneManager->AddSceneNodeRecursively(root);
+	sceneManager->Flush();
+
+	BoxBounds queryBounds(Vector4(-100.0f), Vector4(100.0f));
+	SceneManager::SceneNodes visibleNodes;
+
+	double moveTime = 0.0, flushTime = 0.0, queryTime = 0.0;
+	for (unsigned int frame = 0; frame < frameCount; frame++)
+	{
+		moveTime += benchmark::Measure(1, [&]()
+		{
+			for (auto &mover : movers)
+			{
+				mover.position = mover.position + mover.velocity;
+
+				// bounce off the world's bounds.
+				if (std::abs(mover.position.x) > WORLD_EXTENT) mover.velocity.x = -mover.velocity.x;
+				if (std::abs(mover.position.y) > WORLD_EXTENT) mover.velocity.y = -mover.velocity.y;
+				if (std::abs(mover.position.z) > WORLD_EXTENT) mover.velocity.z = -mover.velocity.z;
+
+				mover.node->SetLocalPosition(mover.position);
+			}
+		});
+
+		// recomposes moved transforms and updates the scene manager in one batch.
+		flushTime += benchmark::Measure(1, [&]()
+		{
+			scene->FlushTransforms();
+		});
+
+		queryTime += benchmark::Measure(1, [&]()
+		{
+			sceneManager->GetVisibleSceneNodes(queryBounds, visibleNodes);
+		});
+	}
+
+	benchmark::Print(name + " move", moveTime / frameCount);
+	benchmark::Print(name + " update + recompose", flushTime / frameCount);
+	benchmark::Print(name + " query", queryTime / frameCount);
+
+	root->RemoveAllChilds();
+	sceneManager->Clear();
+}
+
+int main(int argc, char *argv[])
+{
+	benchmark::Initialize(2);
+
+	unsigned int objectCount = benchmark::GetCount(argc, argv, 1, 20000);
+	unsigned int frameCount = benchmark::GetCount(argc, argv, 2, 100);
+
+	std::cout << objectCount << " moving objects, " << frameCount << " frames, per frame:" << std::endl;
+
+	Vector4 worldMin(-WORLD_EXTENT - 10.0f), worldMax(WORLD_EXTENT + 10.0f);
+
+	Run("OcTree", OcTree::Create(worldMin, worldMax, 6), objectCount, frameCount);
+	Run("LooseOcTree", LooseOcTree::Create(worldMin, worldMax, 6), objectCount, frameCount);
+	Run("SpatialHashGrid", SpatialHashGrid::Create(16.0f), objectCount, frameCount);
+
+	return 0;
+}
\ No newline at end of file
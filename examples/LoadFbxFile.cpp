@@ -101,6 +101,7 @@ void LoadFbxFile::Update(float dt)
 
 void LoadFbxFile::Draw(sf::Window &window)
 {
+	m_Scene->FlushTransforms();
 	m_Pipeline->Execute(m_OcTree);
 }
 
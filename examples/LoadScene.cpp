@@ -67,5 +67,6 @@ void LoadScene::Update(float dt)
 
 void LoadScene::Draw(sf::Window &window)
 {
+	m_Scene->FlushTransforms();
 	m_Pipeline->Execute(m_OcTree);
 }
\ No newline at end of file